@@ -0,0 +1,82 @@
+#ifndef SUBTITLE_H_
+#define SUBTITLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace subtitle {
+
+// Timed transcription formats understood by the parser and the serializer
+enum class Format {
+    Unknown,
+    Bracketed,  // "[HH:MM:SS,mmm - HH:MM:SS,mmm] text", one cue per line (transcribe-audio output)
+    Srt,        // SubRip: index, "start --> end", text lines, blank line
+    WebVtt      // WEBVTT header, optional identifier, "start --> end settings", text lines, blank line
+};
+
+// One timed piece of text. Text spread over several lines is joined with single spaces.
+struct Cue {
+    std::int64_t startMs = 0;
+    std::int64_t endMs = 0;
+    std::string text;
+};
+
+// Function to guess the format from the beginning of a file (a few hundred bytes are enough)
+Format detect_format(std::string_view head);
+
+// Function to guess the format from a file extension (.txt, .srt, .vtt)
+Format format_from_extension(std::string_view path);
+
+// Function to parse "HH:MM:SS,mmm", "HH:MM:SS.mmm", "MM:SS.mmm" or "HH:MM:SS" into milliseconds
+bool parse_timestamp(std::string_view text, std::int64_t &milliseconds);
+
+// Function to format milliseconds as "HH:MM:SS<separator>mmm"
+std::string format_timestamp(std::int64_t milliseconds, char separator = ',');
+
+// Streaming parser. Data is fed in chunks of any size, lines may be cut anywhere, and every
+// complete cue is handed to the handler as soon as it ends, so memory use does not depend on
+// the size of the file.
+class Parser {
+public:
+    using CueHandler = std::function<void(const Cue &)>;
+
+    // With Format::Unknown the format is detected from the first non-blank line
+    Parser(Format format, CueHandler handler);
+
+    void feed(std::string_view data);
+    void finish();
+
+    Format format() const { return inputFormat; }
+    std::size_t cue_count() const { return cues; }
+    std::size_t malformed_count() const { return malformed; }
+
+private:
+    enum class State { Header, Idle, Text, Skip };
+
+    void process_line(std::string_view line);
+    bool start_cue(std::string_view timing);
+    void append_text(std::string_view line);
+    void flush_cue();
+
+    Format inputFormat;
+    CueHandler handler;
+    State state;
+    std::string partial;  // unterminated last line of the previous chunk
+    Cue current;
+    bool firstLine = true;
+    std::size_t cues = 0;
+    std::size_t malformed = 0;
+};
+
+// Function to append what goes before the first cue of a file ("WEBVTT" for WebVTT)
+void write_header(std::string &out, Format format);
+
+// Function to append one cue; index is the 1-based SRT counter
+void write_cue(std::string &out, Format format, const Cue &cue, std::size_t index);
+
+} // namespace subtitle
+
+#endif
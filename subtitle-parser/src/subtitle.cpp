@@ -0,0 +1,418 @@
+#include "../include/subtitle.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <utility>
+
+namespace subtitle {
+
+namespace {
+
+constexpr std::string_view UTF8_BOM = "\xEF\xBB\xBF";
+constexpr std::string_view ARROW = "-->";
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+bool is_digit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && is_space(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && is_space(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+bool starts_with(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+bool all_digits(std::string_view text) {
+    return !text.empty() && std::all_of(text.begin(), text.end(), is_digit);
+}
+
+// Parses a run of digits, false if there is none or it has a non-digit
+bool parse_number(std::string_view text, std::int64_t &value) {
+    if (!all_digits(text) || text.size() > 12) {
+        return false;
+    }
+    value = 0;
+    for (char c : text) {
+        value = value * 10 + (c - '0');
+    }
+    return true;
+}
+
+// Parses "start --> end [settings]" as found in SRT and WebVTT timing lines
+bool parse_timing(std::string_view line, Cue &cue) {
+    std::size_t arrow = line.find(ARROW);
+    if (arrow == std::string_view::npos) {
+        return false;
+    }
+    std::string_view end = trim(line.substr(arrow + ARROW.size()));
+    end = end.substr(0, std::find_if(end.begin(), end.end(), is_space) - end.begin());
+    return parse_timestamp(line.substr(0, arrow), cue.startMs) && parse_timestamp(end, cue.endMs);
+}
+
+// Parses "[start - end] text", the format written by transcribe-audio and transcript-fixer
+bool parse_bracketed(std::string_view line, Cue &cue) {
+    std::size_t close = line.find(']');
+    if (line.empty() || line.front() != '[' || close == std::string_view::npos) {
+        return false;
+    }
+    std::string_view times = line.substr(1, close - 1);
+    std::size_t dash = times.find('-');
+    if (dash == std::string_view::npos || !parse_timestamp(times.substr(0, dash), cue.startMs) ||
+        !parse_timestamp(times.substr(dash + 1), cue.endMs)) {
+        return false;
+    }
+    std::string_view text = line.substr(close + 1);
+    while (!text.empty() && is_space(text.front())) {
+        text.remove_prefix(1);
+    }
+    cue.text.assign(text);
+    return true;
+}
+
+// Guesses the format from the first non-blank line of a file
+Format detect_line(std::string_view line) {
+    Cue cue;
+    if (starts_with(line, "WEBVTT")) {
+        return Format::WebVtt;
+    }
+    if (parse_bracketed(line, cue)) {
+        return Format::Bracketed;
+    }
+    if (all_digits(trim(line)) || parse_timing(line, cue)) {
+        return Format::Srt;
+    }
+    return Format::Unknown;
+}
+
+// Appends WebVTT cue text without its markup: tags such as <v Speaker> or <i> are dropped
+// and the character references the format allows are decoded
+void append_webvtt_text(std::string &out, std::string_view line) {
+    static const std::pair<std::string_view, std::string_view> references[] = {
+        {"&amp;", "&"}, {"&lt;", "<"}, {"&gt;", ">"}, {"&nbsp;", " "}, {"&lrm;", ""}, {"&rlm;", ""}};
+    std::size_t i = 0;
+    while (i < line.size()) {
+        if (line[i] == '<') {
+            std::size_t close = line.find('>', i);
+            i = close == std::string_view::npos ? line.size() : close + 1;
+            continue;
+        }
+        if (line[i] == '&') {
+            auto reference = std::find_if(std::begin(references), std::end(references), [&](const auto &entry) {
+                return starts_with(line.substr(i), entry.first);
+            });
+            if (reference != std::end(references)) {
+                out.append(reference->second);
+                i += reference->first.size();
+                continue;
+            }
+        }
+        out.push_back(line[i++]);
+    }
+}
+
+} // namespace
+
+// Function to guess the format from the beginning of a file
+Format detect_format(std::string_view head) {
+    if (starts_with(head, UTF8_BOM)) {
+        head.remove_prefix(UTF8_BOM.size());
+    }
+    // A number alone could start plain text too, SRT also needs the timing line after it
+    bool expectTiming = false;
+    while (!head.empty()) {
+        std::size_t newline = head.find('\n');
+        std::string_view line = head.substr(0, newline);
+        if (!trim(line).empty()) {
+            Cue cue;
+            if (expectTiming) {
+                return parse_timing(line, cue) ? Format::Srt : Format::Unknown;
+            }
+            if (!all_digits(trim(line))) {
+                return detect_line(line);
+            }
+            expectTiming = true;
+        }
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        head.remove_prefix(newline + 1);
+    }
+    return Format::Unknown;
+}
+
+// Function to guess the format from a file extension
+Format format_from_extension(std::string_view path) {
+    std::size_t dot = path.find_last_of('.');
+    if (dot == std::string_view::npos) {
+        return Format::Unknown;
+    }
+    std::string extension(path.substr(dot + 1));
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == "srt") {
+        return Format::Srt;
+    }
+    if (extension == "vtt") {
+        return Format::WebVtt;
+    }
+    if (extension == "txt") {
+        return Format::Bracketed;
+    }
+    return Format::Unknown;
+}
+
+// Function to parse a timestamp into milliseconds
+bool parse_timestamp(std::string_view text, std::int64_t &milliseconds) {
+    text = trim(text);
+
+    // Fraction of a second, after ',' (SRT) or '.' (WebVTT); any precision, kept to milliseconds
+    std::int64_t fraction = 0;
+    std::size_t separator = text.find_first_of(",.");
+    if (separator != std::string_view::npos) {
+        std::string digits(text.substr(separator + 1));
+        if (!all_digits(digits)) {
+            return false;
+        }
+        digits.resize(3, '0');
+        parse_number(digits, fraction);
+        text = text.substr(0, separator);
+    }
+
+    // Hours are optional in WebVTT
+    std::int64_t fields[3] = {0, 0, 0};
+    int count = 0;
+    while (true) {
+        std::size_t colon = text.find(':');
+        if (count == 3 || !parse_number(text.substr(0, colon), fields[count])) {
+            return false;
+        }
+        ++count;
+        if (colon == std::string_view::npos) {
+            break;
+        }
+        text.remove_prefix(colon + 1);
+    }
+    if (count < 2) {
+        return false;
+    }
+    std::int64_t hours = count == 3 ? fields[0] : 0;
+    std::int64_t minutes = fields[count - 2];
+    std::int64_t seconds = fields[count - 1];
+    if (minutes >= 60 || seconds >= 60) {
+        return false;
+    }
+    milliseconds = ((hours * 60 + minutes) * 60 + seconds) * 1000 + fraction;
+    return true;
+}
+
+// Function to format milliseconds as a timestamp
+std::string format_timestamp(std::int64_t milliseconds, char separator) {
+    milliseconds = std::max<std::int64_t>(milliseconds, 0);
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%02lld:%02lld:%02lld%c%03lld",
+                  static_cast<long long>(milliseconds / 3600000), static_cast<long long>(milliseconds / 60000 % 60),
+                  static_cast<long long>(milliseconds / 1000 % 60), separator,
+                  static_cast<long long>(milliseconds % 1000));
+    return buffer;
+}
+
+Parser::Parser(Format format, CueHandler handler)
+    : inputFormat(format), handler(std::move(handler)), state(format == Format::WebVtt ? State::Header : State::Idle) {
+}
+
+void Parser::feed(std::string_view data) {
+    while (!data.empty()) {
+        std::size_t newline = data.find('\n');
+        if (newline == std::string_view::npos) {
+            partial.append(data);
+            return;
+        }
+        if (partial.empty()) {
+            process_line(data.substr(0, newline));
+        } else {
+            partial.append(data.substr(0, newline));
+            process_line(partial);
+            partial.clear();
+        }
+        data.remove_prefix(newline + 1);
+    }
+}
+
+void Parser::finish() {
+    if (!partial.empty()) {
+        std::string last;
+        last.swap(partial);
+        process_line(last);
+    }
+    // The last cue of a file often has no blank line after it
+    if (state == State::Text) {
+        flush_cue();
+    }
+    state = State::Idle;
+}
+
+void Parser::process_line(std::string_view line) {
+    if (firstLine) {
+        firstLine = false;
+        if (starts_with(line, UTF8_BOM)) {
+            line.remove_prefix(UTF8_BOM.size());
+        }
+    }
+    if (!line.empty() && line.back() == '\r') {
+        line.remove_suffix(1);
+    }
+    bool blank = trim(line).empty();
+
+    if (inputFormat == Format::Unknown) {
+        if (blank) {
+            return;
+        }
+        inputFormat = detect_line(line);
+        if (inputFormat == Format::Unknown) {
+            ++malformed;
+            return;
+        }
+        if (inputFormat == Format::WebVtt) {
+            state = State::Header;
+            return;
+        }
+    }
+
+    if (inputFormat == Format::Bracketed) {
+        if (!blank) {
+            if (parse_bracketed(line, current)) {
+                flush_cue();
+            } else {
+                current = Cue{};
+                ++malformed;
+            }
+        }
+        return;
+    }
+
+    switch (state) {
+    case State::Header:
+    case State::Skip:
+        // The WebVTT header and NOTE, STYLE and REGION blocks run until the next blank line
+        if (blank) {
+            state = State::Idle;
+        }
+        return;
+    case State::Text:
+        if (blank) {
+            flush_cue();
+            state = State::Idle;
+        } else {
+            append_text(line);
+        }
+        return;
+    case State::Idle:
+        break;
+    }
+
+    if (blank) {
+        return;
+    }
+    if (line.find(ARROW) != std::string_view::npos) {
+        if (start_cue(line)) {
+            state = State::Text;
+        } else {
+            ++malformed;
+            state = State::Skip;
+        }
+        return;
+    }
+    if (inputFormat == Format::WebVtt) {
+        // Anything else before a timing line is a comment block or a cue identifier
+        if (starts_with(line, "NOTE") || starts_with(line, "STYLE") || starts_with(line, "REGION")) {
+            state = State::Skip;
+        }
+        return;
+    }
+    if (!all_digits(trim(line))) {
+        ++malformed;  // SRT text outside of a cue
+    }
+}
+
+bool Parser::start_cue(std::string_view timing) {
+    current = Cue{};
+    return parse_timing(timing, current);
+}
+
+void Parser::append_text(std::string_view line) {
+    line = trim(line);
+    if (line.empty()) {
+        return;
+    }
+    if (!current.text.empty()) {
+        current.text.push_back(' ');
+    }
+    if (inputFormat == Format::WebVtt) {
+        append_webvtt_text(current.text, line);
+    } else {
+        current.text.append(line);
+    }
+}
+
+void Parser::flush_cue() {
+    ++cues;
+    handler(current);
+    current = Cue{};
+}
+
+// Function to append what goes before the first cue of a file
+void write_header(std::string &out, Format format) {
+    if (format == Format::WebVtt) {
+        out.append("WEBVTT\n\n");
+    }
+}
+
+// Function to append one cue
+void write_cue(std::string &out, Format format, const Cue &cue, std::size_t index) {
+    switch (format) {
+    case Format::Bracketed:
+        out.append("[").append(format_timestamp(cue.startMs)).append(" - ").append(format_timestamp(cue.endMs));
+        out.append("] ").append(cue.text).append("\n");
+        break;
+    case Format::Srt:
+        out.append(std::to_string(index)).append("\n");
+        out.append(format_timestamp(cue.startMs)).append(" --> ").append(format_timestamp(cue.endMs)).append("\n");
+        out.append(cue.text).append("\n\n");
+        break;
+    case Format::WebVtt:
+        out.append(format_timestamp(cue.startMs, '.')).append(" --> ").append(format_timestamp(cue.endMs, '.'));
+        out.append("\n");
+        for (char c : cue.text) {
+            switch (c) {
+            case '&':
+                out.append("&amp;");
+                break;
+            case '<':
+                out.append("&lt;");
+                break;
+            case '>':
+                out.append("&gt;");
+                break;
+            default:
+                out.push_back(c);
+                break;
+            }
+        }
+        out.append("\n\n");
+        break;
+    case Format::Unknown:
+        break;
+    }
+}
+
+} // namespace subtitle
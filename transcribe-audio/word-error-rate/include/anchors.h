@@ -0,0 +1,14 @@
+#ifndef ANCHORS_H_
+#define ANCHORS_H_
+
+#include <string>
+#include <vector>
+
+// Function to compute the Levenshtein distance by splitting the problem at words that occur
+// exactly once in both transcriptions (patience-diff style anchors) and solving the pieces in
+// parallel. The result is the cost of a valid alignment, so it is never below the exact
+// distance, and it is equal to it whenever the anchors lie on an optimal alignment.
+int anchored_levenshtein_distance(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                                  unsigned int threads);
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef BITPARALLEL_H_
+#define BITPARALLEL_H_
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// A reference transcription preprocessed once for Myers' bit-vector Levenshtein algorithm
+// (block-based, as described by Hyyrö). The match masks (Peq tables) of every reference word
+// are built in the constructor; distance() only reads them, so any number of threads can
+// score hypotheses against the same reference at O(n * m / 64) each.
+class BitParallelReference {
+public:
+    explicit BitParallelReference(const std::vector<std::string> &words);
+
+    int distance(const std::vector<std::string> &hypothesis) const;
+    std::size_t size() const { return length; }
+
+private:
+    std::unordered_map<std::string, int> ids;   // interned reference words
+    std::size_t length;
+    std::size_t blocks;                         // 64-word blocks covering the reference
+    std::vector<std::uint64_t> peq;             // peq[id * blocks + b]: positions of word id in block b
+};
+
+#endif
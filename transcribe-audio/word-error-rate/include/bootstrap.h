@@ -0,0 +1,28 @@
+#ifndef BOOTSTRAP_H_
+#define BOOTSTRAP_H_
+
+#include <cstdint>
+#include <vector>
+
+// Per-utterance error counts of one system (A), or of two systems (A and B) scored against the same references
+struct UtteranceCounts {
+    double editsA;
+    double editsB;
+    std::size_t referenceWords;
+};
+
+struct BootstrapResult {
+    double werA, lowA, highA;   // corpus WER of system A and its confidence interval, in percent
+    double werB, lowB, highB;   // same for system B (paired runs only)
+    double pValue;              // two-sided p-value of "A and B have the same WER" (paired runs only)
+};
+
+// Function to estimate confidence intervals of the corpus WER (and, if paired, the significance of
+// the difference between two systems) by resampling utterances with replacement. The resamples are
+// split into fixed blocks that a pool of threads works through; each thread has its own random
+// generator, reseeded from the seed and the block index at the start of every block, so the result
+// only depends on the seed and not on the number of threads.
+BootstrapResult bootstrap_wer(const std::vector<UtteranceCounts> &utterances, bool paired, int resamples,
+                              unsigned int threads, std::uint64_t seed, double confidence = 0.95);
+
+#endif
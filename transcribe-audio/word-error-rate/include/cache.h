@@ -0,0 +1,28 @@
+#ifndef CACHE_H_
+#define CACHE_H_
+
+#include "scoring.h"
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// On-disk cache of distances, one small file per result, keyed by a hash of the normalized
+// words of both transcriptions and of the scoring settings
+class ResultCache {
+public:
+    explicit ResultCache(std::string directory);
+
+    static std::uint64_t make_key(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                                  const std::string &settings);
+
+    std::optional<PairScore> lookup(std::uint64_t key, std::size_t originalWords, std::size_t targetWords) const;
+    void store(std::uint64_t key, const PairScore &result) const;
+
+private:
+    std::string path_for(std::uint64_t key) const;
+
+    std::string directory;
+};
+
+#endif
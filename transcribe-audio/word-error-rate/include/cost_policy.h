@@ -0,0 +1,117 @@
+#ifndef COST_POLICY_H_
+#define COST_POLICY_H_
+
+#include "stats.h"
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Cost policies for edit_distance(). A policy works on interned word ids and provides
+// cost_type, insertion(), deletion() and substitution(); the kernel is instantiated per
+// policy, so no virtual call is made inside the DP loop.
+
+// Plain Levenshtein costs; everything folds to constants and edit_distance<UnitCost> is the
+// classic integer loop
+struct UnitCost {
+    using cost_type = int;
+
+    static constexpr cost_type insertion(int) { return 1; }
+    static constexpr cost_type deletion(int) { return 1; }
+    static constexpr cost_type substitution(int original, int target) { return original == target ? 0 : 1; }
+};
+
+// The contents of a cost file, parsed once per run and bound to the words of each pair by
+// WeightedCost::bind
+struct CostTable {
+    float insertion = 1;
+    float deletion = 1;
+    float substitution = 1;
+    float accent = 1;
+    std::vector<std::tuple<std::string, std::string, float>> pairs;  // cleaned words, in file order
+
+    // Loads a cost file with lines "insertion|deletion|substitution|accent <cost>" or
+    // "<word> <word> <cost>", or gives no value if the file cannot be read
+    static std::optional<CostTable> load(const std::string &filename);
+
+    // Function to describe the costs, as part of the cache key
+    std::string describe() const;
+};
+
+// Table-driven weighted costs: per-pair substitution costs (e.g. homophones), a reduced cost for
+// words that only differ in accents, and configurable insertion/deletion/substitution defaults
+class WeightedCost {
+public:
+    using cost_type = float;
+
+    // Builds the policy for a vocabulary of interned words (vocabulary[id] is the word)
+    static WeightedCost bind(const CostTable &table, const std::vector<std::string> &vocabulary);
+
+    cost_type insertion(int) const { return insertionCost; }
+    cost_type deletion(int) const { return deletionCost; }
+    cost_type substitution(int original, int target) const {
+        if (original == target) {
+            return 0;
+        }
+        if (hasPairCost[original] && hasPairCost[target]) {
+            auto it = pairCosts.find(pair_key(original, target));
+            if (it != pairCosts.end()) {
+                return it->second;
+            }
+        }
+        return foldedIds[original] == foldedIds[target] ? accentCost : substitutionCost;
+    }
+
+private:
+    static std::uint64_t pair_key(int a, int b) {
+        return (static_cast<std::uint64_t>(std::min(a, b)) << 32) | static_cast<std::uint32_t>(std::max(a, b));
+    }
+
+    cost_type insertionCost = 1;
+    cost_type deletionCost = 1;
+    cost_type substitutionCost = 1;
+    cost_type accentCost = 1;
+    std::vector<int> foldedIds;         // id of the accent-free spelling of every word
+    std::vector<char> hasPairCost;      // quick reject before hashing
+    std::unordered_map<std::uint64_t, cost_type> pairCosts;
+};
+
+// Function to remove the accents of the Latin-1 letters in a UTF-8 word (e.g. "canción" -> "cancion")
+std::string fold_accents(const std::string &word);
+
+// Function to compute the edit distance between two sequences of word ids under a cost policy,
+// keeping only two rows of the DP matrix
+template <typename CostPolicy>
+typename CostPolicy::cost_type edit_distance(std::span<const int> original, std::span<const int> target,
+                                             const CostPolicy &policy = CostPolicy{}) {
+    using cost_type = typename CostPolicy::cost_type;
+    std::size_t m = original.size();
+    std::size_t n = target.size();
+    record_stat(&RunStats::dpCells, static_cast<std::int64_t>(m * n));
+
+    std::vector<cost_type> previous(n + 1), current(n + 1);
+    previous[0] = 0;
+    for (std::size_t j = 1; j <= n; ++j) {
+        previous[j] = previous[j - 1] + policy.insertion(target[j - 1]);
+    }
+
+    for (std::size_t i = 1; i <= m; ++i) {
+        int word = original[i - 1];
+        cost_type deletion = policy.deletion(word);
+        current[0] = previous[0] + deletion;
+        for (std::size_t j = 1; j <= n; ++j) {
+            current[j] = std::min({previous[j] + deletion,
+                                   current[j - 1] + policy.insertion(target[j - 1]),
+                                   previous[j - 1] + policy.substitution(word, target[j - 1])});
+        }
+        std::swap(previous, current);
+    }
+    return previous[n];
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef HELPER_H_
 #define HELPER_H_
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -13,10 +14,22 @@ std::vector<std::string> split_into_words(const std::string &str);
 // Function to compute the Levenshtein distance
 int levenshtein_distance(const std::vector<std::string> &original, const std::vector<std::string> &target);
 
+// Function to map the words of both transcriptions to integer ids, equal words getting equal ids.
+// If vocabulary is given it receives the word of every id.
+void intern_words(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                  std::vector<int> &originalIds, std::vector<int> &targetIds,
+                  std::vector<std::string> *vocabulary = nullptr);
+
+// Function to turn an edit distance into a Word Error Rate (WER) percentage
+float wer_from_distance(double distance, std::size_t originalWords);
+
 // Function to calculate the Word Error Rate (WER)
 float calculate_wer(const std::vector<std::string> &original, const std::vector<std::string> &target);
 
-// Function to read a transcription file and return the words
-std::vector<std::string> read_transcription_file(const std::string &filename);
+// Function to read a transcription and return the words. The file may be a named pipe, "-" for
+// standard input, or gzip (zstd with ZSTD=1) compressed; it is read in bounded chunks. SRT, WebVTT
+// and bracketed "[start - end] text" files are recognized and only the text of their cues is kept.
+// Returns no value, after printing the reason, if the file cannot be opened or read to its end.
+std::optional<std::vector<std::string>> read_transcription_file(const std::string &filename);
 
 #endif
\ No newline at end of file
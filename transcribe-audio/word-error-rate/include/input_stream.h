@@ -0,0 +1,50 @@
+#ifndef INPUT_STREAM_H_
+#define INPUT_STREAM_H_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Sequential reader for transcription input: regular files, named pipes, or standard input
+// ("-"). gzip input is decompressed on the fly, and so is zstd when built with ZSTD=1. The
+// format is detected from the first bytes, so pipes never need to be rewound, and memory use
+// is bounded by one input chunk whatever the size of the stream.
+class InputStream {
+public:
+    explicit InputStream(const std::string &path);
+    ~InputStream();
+    InputStream(const InputStream &) = delete;
+    InputStream &operator=(const InputStream &) = delete;
+
+    bool is_open() const { return fd >= 0; }
+    const std::string &error() const { return errorMessage; }
+
+    // Reads up to size decoded bytes into buffer; returns 0 at the end of the stream or on error
+    std::size_t read(char *buffer, std::size_t size);
+
+private:
+    enum class Format {
+        Plain,
+        Gzip,
+        Zstd
+    };
+
+    struct Decoder;
+
+    bool fill_input();
+    std::size_t read_plain(char *buffer, std::size_t size);
+    void report_truncation(const char *compression);
+
+    int fd;
+    bool ownsFd;
+    bool endOfInput;
+    Format format;
+    std::vector<char> input;        // raw (possibly compressed) bytes not yet consumed
+    std::size_t inputBegin;
+    std::size_t inputEnd;
+    std::unique_ptr<Decoder> decoder;
+    std::string errorMessage;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef NORMALIZER_H_
+#define NORMALIZER_H_
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Token-level rewrite rules (numbers, contractions, filler words, spelling variants) compiled
+// into a trie over words. apply() rewrites a transcription in one left-to-right pass, always
+// taking the longest rule that matches at the current word.
+class Normalizer {
+public:
+    // Loads rules of the form "<words> => <words>" (an empty right-hand side deletes the words),
+    // or gives no value if the file cannot be read
+    static std::optional<Normalizer> load(const std::string &filename);
+
+    std::vector<std::string> apply(const std::vector<std::string> &words) const;
+    std::size_t rule_count() const { return replacements.size(); }
+
+private:
+    struct Node {
+        std::unordered_map<std::string, int> children;
+        int rule = -1;      // index into replacements when a pattern ends here
+    };
+
+    void add_rule(const std::vector<std::string> &pattern, const std::vector<std::string> &replacement);
+
+    std::vector<Node> nodes{Node{}};    // nodes[0] is the root
+    std::vector<std::vector<std::string>> replacements;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef SCORING_H_
+#define SCORING_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+struct CostTable;
+class Normalizer;
+class ResultCache;
+
+// Algorithm used to compute the distance between two transcriptions
+enum class Algorithm {
+    Exact,
+    Anchored,
+    Wavefront
+};
+
+struct ScoringOptions {
+    Algorithm algorithm = Algorithm::Exact;
+    const CostTable *costs = nullptr;   // weighted costs when set, only with Algorithm::Exact
+    unsigned int threads = 1;
+};
+
+// Distance between two transcriptions along with their lengths in words
+struct PairScore {
+    double distance;
+    std::size_t originalWords;
+    std::size_t targetWords;
+};
+
+// Function to compute the edit distance between two (already normalized) transcriptions
+double compute_distance(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                        const ScoringOptions &options);
+
+// Function to describe everything in the options that can change a distance, the costs included
+std::string describe_options(const ScoringOptions &options);
+
+// Function to read, normalize (if a normalizer is given) and score two transcription files,
+// reusing and filling the cache if one is given. An empty file is scored like any other, every
+// word of the other one counting as an edit; a file that cannot be read gives no value.
+std::optional<PairScore> score_files(const std::string &originalFile, const std::string &targetFile,
+                                     const ScoringOptions &options, const Normalizer *normalizer,
+                                     const ResultCache *cache);
+
+#endif
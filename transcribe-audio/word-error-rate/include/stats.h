@@ -0,0 +1,60 @@
+#ifndef STATS_H_
+#define STATS_H_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Counters behind --stats. They are only updated once enable_stats() has been called, so a normal
+// run pays one relaxed load per instrumented call. Stage times are summed over all threads.
+struct RunStats {
+    std::atomic<std::int64_t> readNanoseconds{0};       // read_transcription_file, cleaning included
+    std::atomic<std::int64_t> cleanNanoseconds{0};      // clean_string within read_transcription_file
+    std::atomic<std::int64_t> normalizeNanoseconds{0};  // Normalizer::apply
+    std::atomic<std::int64_t> distanceNanoseconds{0};   // the edit distance kernels
+    std::atomic<std::int64_t> pairs{0};
+    std::atomic<std::int64_t> cacheHits{0};
+    std::atomic<std::int64_t> originalWords{0};
+    std::atomic<std::int64_t> targetWords{0};
+    std::atomic<std::int64_t> dpCells{0};
+};
+
+// Function to turn the statistics on for the rest of the run
+void enable_stats();
+
+// Function to check whether statistics are being collected
+inline bool stats_enabled() {
+    extern std::atomic<bool> statsEnabled;
+    return statsEnabled.load(std::memory_order_relaxed);
+}
+
+// Function to access the process-wide counters
+RunStats &run_stats();
+
+// Function to add to one of the counters if statistics are being collected
+inline void record_stat(std::atomic<std::int64_t> RunStats::*counter, std::int64_t amount) {
+    if (stats_enabled()) {
+        (run_stats().*counter).fetch_add(amount, std::memory_order_relaxed);
+    }
+}
+
+// Function to print the counters along with the total wall time, the peak resident set size
+// and the number of heap allocations made since enable_stats(), as aligned text or as a single
+// JSON object
+void print_stats(std::ostream &out, bool json);
+
+// Adds the time between its construction and its destruction to one stage of the statistics
+class StageTimer {
+public:
+    explicit StageTimer(std::atomic<std::int64_t> RunStats::*stage);
+    ~StageTimer();
+    StageTimer(const StageTimer &) = delete;
+    StageTimer &operator=(const StageTimer &) = delete;
+
+private:
+    std::atomic<std::int64_t> *counter;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif
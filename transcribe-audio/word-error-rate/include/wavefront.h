@@ -0,0 +1,13 @@
+#ifndef WAVEFRONT_H_
+#define WAVEFRONT_H_
+
+#include <string>
+#include <vector>
+
+// Function to compute the exact Levenshtein distance of a single large pair on several threads.
+// The DP matrix is cut into tileSize x tileSize tiles that are processed one anti-diagonal at a
+// time; tiles on the same anti-diagonal are independent and only exchange their edge rows/columns.
+int wavefront_levenshtein_distance(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                                   unsigned int threads, int tileSize = 512);
+
+#endif
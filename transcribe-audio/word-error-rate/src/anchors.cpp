@@ -0,0 +1,148 @@
+#include "../include/anchors.h"
+#include "../include/helper.h"
+#include "../include/cost_policy.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+// Gaps smaller than this on either side are cheaper to solve directly than to split further
+constexpr int MIN_SPLIT_SIZE = 64;
+
+struct Gap {
+    int originalBegin;
+    int originalEnd;
+    int targetBegin;
+    int targetEnd;
+};
+
+// Distance between the two stretches of interned word ids covered by a gap
+int gap_distance(const std::vector<int> &original, const std::vector<int> &target, const Gap &gap) {
+    std::span<const int> originalWords(original.data() + gap.originalBegin, gap.originalEnd - gap.originalBegin);
+    std::span<const int> targetWords(target.data() + gap.targetBegin, gap.targetEnd - gap.targetBegin);
+    return edit_distance<UnitCost>(originalWords, targetWords);
+}
+
+// Longest chain of (original, target) pairs increasing in both coordinates, by patience sorting.
+// The pairs come sorted by original position.
+std::vector<std::pair<int, int>> longest_increasing_chain(const std::vector<std::pair<int, int>> &pairs) {
+    std::vector<int> pileTops;              // index into pairs of the top card of each pile
+    std::vector<int> predecessor(pairs.size(), -1);
+    for (int k = 0; k < static_cast<int>(pairs.size()); ++k) {
+        auto pile = std::lower_bound(pileTops.begin(), pileTops.end(), pairs[k].second,
+                                     [&pairs](int top, int value) { return pairs[top].second < value; });
+        if (pile != pileTops.begin()) {
+            predecessor[k] = *(pile - 1);
+        }
+        if (pile == pileTops.end()) {
+            pileTops.push_back(k);
+        } else {
+            *pile = k;
+        }
+    }
+
+    std::vector<std::pair<int, int>> chain;
+    for (int k = pileTops.empty() ? -1 : pileTops.back(); k != -1; k = predecessor[k]) {
+        chain.push_back(pairs[k]);
+    }
+    std::reverse(chain.begin(), chain.end());
+    return chain;
+}
+
+// Splits a gap at its unique common words, then the sub-gaps in turn, and collects the leaves.
+// Words that were repeated in a gap can be unique in a sub-gap, so the splits can nest about as
+// deep as the gap is long; a work list keeps that off the call stack.
+std::vector<Gap> split_gaps(const std::vector<int> &original, const std::vector<int> &target, const Gap &whole) {
+    std::vector<Gap> leaves;
+    std::vector<Gap> pending{whole};
+    while (!pending.empty()) {
+        Gap gap = pending.back();
+        pending.pop_back();
+        if (gap.originalEnd - gap.originalBegin < MIN_SPLIT_SIZE || gap.targetEnd - gap.targetBegin < MIN_SPLIT_SIZE) {
+            leaves.push_back(gap);
+            continue;
+        }
+
+        // Occurrence counts and last position of every word on each side
+        std::unordered_map<int, std::pair<int, int>> originalCount, targetCount;
+        for (int i = gap.originalBegin; i < gap.originalEnd; ++i) {
+            auto &entry = originalCount[original[i]];
+            ++entry.first;
+            entry.second = i;
+        }
+        for (int j = gap.targetBegin; j < gap.targetEnd; ++j) {
+            auto &entry = targetCount[target[j]];
+            ++entry.first;
+            entry.second = j;
+        }
+
+        std::vector<std::pair<int, int>> candidates;
+        for (int i = gap.originalBegin; i < gap.originalEnd; ++i) {
+            if (originalCount[original[i]].first != 1) {
+                continue;
+            }
+            auto it = targetCount.find(original[i]);
+            if (it != targetCount.end() && it->second.first == 1) {
+                candidates.emplace_back(i, it->second.second);
+            }
+        }
+
+        std::vector<std::pair<int, int>> anchors = longest_increasing_chain(candidates);
+        if (anchors.empty()) {
+            leaves.push_back(gap);
+            continue;
+        }
+
+        // Anchored words match at no cost, only the stretches between them need aligning
+        int originalBegin = gap.originalBegin;
+        int targetBegin = gap.targetBegin;
+        for (const auto &anchor : anchors) {
+            pending.push_back({originalBegin, anchor.first, targetBegin, anchor.second});
+            originalBegin = anchor.first + 1;
+            targetBegin = anchor.second + 1;
+        }
+        pending.push_back({originalBegin, gap.originalEnd, targetBegin, gap.targetEnd});
+    }
+    return leaves;
+}
+
+} // namespace
+
+int anchored_levenshtein_distance(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                                  unsigned int threads) {
+    // Intern the words so that hashing and comparisons work on integers
+    std::vector<int> originalIds, targetIds;
+    intern_words(original, target, originalIds, targetIds);
+
+    std::vector<Gap> leaves =
+        split_gaps(originalIds, targetIds, {0, static_cast<int>(originalIds.size()), 0, static_cast<int>(targetIds.size())});
+
+    // Largest pieces first so that one big gap does not end up last on a single thread
+    std::sort(leaves.begin(), leaves.end(), [](const Gap &a, const Gap &b) {
+        return static_cast<long long>(a.originalEnd - a.originalBegin) * (a.targetEnd - a.targetBegin) >
+               static_cast<long long>(b.originalEnd - b.originalBegin) * (b.targetEnd - b.targetBegin);
+    });
+
+    std::atomic<std::size_t> nextLeaf{0};
+    std::atomic<int> total{0};
+    auto worker = [&]() {
+        int partial = 0;
+        for (std::size_t k = nextLeaf++; k < leaves.size(); k = nextLeaf++) {
+            partial += gap_distance(originalIds, targetIds, leaves[k]);
+        }
+        total += partial;
+    };
+
+    threads = std::max(1u, std::min<unsigned int>(threads, leaves.size()));
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+    return total;
+}
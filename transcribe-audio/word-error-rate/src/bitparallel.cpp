@@ -0,0 +1,78 @@
+#include "../include/bitparallel.h"
+#include "../include/stats.h"
+
+namespace {
+
+// Advances one 64-row block of the DP column by one hypothesis word. Pv/Mv hold the positive and
+// negative vertical deltas of the block, hin is the horizontal delta entering at its top and the
+// return value the one leaving at the row marked by lastBit.
+int advance_block(std::uint64_t &pv, std::uint64_t &mv, std::uint64_t eq, int hin, std::uint64_t lastBit) {
+    std::uint64_t xv = eq | mv;
+    if (hin < 0) {
+        eq |= 1;
+    }
+    std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+    std::uint64_t ph = mv | ~(xh | pv);
+    std::uint64_t mh = pv & xh;
+
+    int hout = 0;
+    if (ph & lastBit) {
+        hout = 1;
+    } else if (mh & lastBit) {
+        hout = -1;
+    }
+
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) {
+        mh |= 1;
+    } else if (hin > 0) {
+        ph |= 1;
+    }
+    pv = mh | ~(xv | ph);
+    mv = ph & xv;
+    return hout;
+}
+
+} // namespace
+
+BitParallelReference::BitParallelReference(const std::vector<std::string> &words)
+    : length(words.size()), blocks((words.size() + 63) / 64) {
+    std::vector<int> wordIds;
+    wordIds.reserve(words.size());
+    for (const std::string &word : words) {
+        wordIds.push_back(ids.emplace(word, static_cast<int>(ids.size())).first->second);
+    }
+
+    peq.assign(ids.size() * blocks, 0);
+    for (std::size_t i = 0; i < wordIds.size(); ++i) {
+        peq[wordIds[i] * blocks + i / 64] |= std::uint64_t{1} << (i % 64);
+    }
+}
+
+int BitParallelReference::distance(const std::vector<std::string> &hypothesis) const {
+    StageTimer timer(&RunStats::distanceNanoseconds);
+    record_stat(&RunStats::dpCells, static_cast<std::int64_t>(length) * hypothesis.size());
+    if (blocks == 0) {
+        return static_cast<int>(hypothesis.size());
+    }
+
+    // First column of the DP matrix: every vertical delta is +1
+    std::vector<std::uint64_t> pv(blocks, ~std::uint64_t{0}), mv(blocks, 0);
+    std::uint64_t lastBit = std::uint64_t{1} << ((length - 1) % 64);
+    int score = static_cast<int>(length);
+
+    for (const std::string &word : hypothesis) {
+        auto it = ids.find(word);
+        const std::uint64_t *eq = it == ids.end() ? nullptr : &peq[it->second * blocks];
+
+        // The top row grows by one per hypothesis word
+        int carry = 1;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            carry = advance_block(pv[b], mv[b], eq ? eq[b] : 0, carry,
+                                  b + 1 == blocks ? lastBit : std::uint64_t{1} << 63);
+        }
+        score += carry;
+    }
+    return score;
+}
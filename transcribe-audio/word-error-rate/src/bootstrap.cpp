@@ -0,0 +1,114 @@
+#include "../include/bootstrap.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
+namespace {
+
+constexpr int blockSize = 64;   // resamples drawn from one reseeded generator
+
+// Function to mix a 64-bit value (splitmix64), used to derive an independent seed for each block
+std::uint64_t splitmix64(std::uint64_t value) {
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return value ^ (value >> 31);
+}
+
+double corpus_wer(double edits, double referenceWords) {
+    return referenceWords > 0 ? edits * 100 / referenceWords : 0;
+}
+
+double percentile(std::vector<double> &values, double fraction) {
+    if (values.empty()) {
+        return 0;
+    }
+    std::size_t index = std::min(values.size() - 1, static_cast<std::size_t>(fraction * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+} // namespace
+
+BootstrapResult bootstrap_wer(const std::vector<UtteranceCounts> &utterances, bool paired, int resamples,
+                              unsigned int threads, std::uint64_t seed, double confidence) {
+    double totalA = 0, totalB = 0, totalWords = 0;
+    for (const UtteranceCounts &utterance : utterances) {
+        totalA += utterance.editsA;
+        totalB += utterance.editsB;
+        totalWords += utterance.referenceWords;
+    }
+
+    BootstrapResult result{};
+    result.werA = corpus_wer(totalA, totalWords);
+    result.werB = corpus_wer(totalB, totalWords);
+    if (utterances.empty() || resamples <= 0) {
+        result.lowA = result.highA = result.werA;
+        result.lowB = result.highB = result.werB;
+        result.pValue = 1;
+        return result;
+    }
+
+    int blocks = (resamples + blockSize - 1) / blockSize;
+    threads = std::max(1u, std::min<unsigned int>(threads, blocks));
+    std::vector<double> samplesA(resamples), samplesB(paired ? resamples : 0);
+    std::vector<int> notBetter(threads, 0), notWorse(threads, 0);   // per thread, no shared counters
+    std::atomic<int> nextBlock{0};
+
+    // Threads take whole blocks of resamples; each block reseeds the thread's generator from
+    // (seed, block index), so every resample is the same whichever thread draws it
+    auto worker = [&](unsigned int id) {
+        std::mt19937_64 generator;
+        std::uniform_int_distribution<std::size_t> pick(0, utterances.size() - 1);
+        for (int block = nextBlock++; block < blocks; block = nextBlock++) {
+            generator.seed(splitmix64(seed ^ splitmix64(block)));
+            pick.reset();
+            int end = std::min(resamples, (block + 1) * blockSize);
+            for (int r = block * blockSize; r < end; ++r) {
+                double editsA = 0, editsB = 0, words = 0;
+                for (std::size_t k = 0; k < utterances.size(); ++k) {
+                    const UtteranceCounts &utterance = utterances[pick(generator)];
+                    editsA += utterance.editsA;
+                    editsB += utterance.editsB;
+                    words += utterance.referenceWords;
+                }
+                samplesA[r] = corpus_wer(editsA, words);
+                if (paired) {
+                    samplesB[r] = corpus_wer(editsB, words);
+                    // Paired test: same resampled utterances for both systems
+                    notBetter[id] += editsA >= editsB;
+                    notWorse[id] += editsA <= editsB;
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+
+    double tail = (1 - confidence) / 2;
+    result.lowA = percentile(samplesA, tail);
+    result.highA = percentile(samplesA, 1 - tail);
+    if (paired) {
+        result.lowB = percentile(samplesB, tail);
+        result.highB = percentile(samplesB, 1 - tail);
+        double aNotBetter = 0, aNotWorse = 0;
+        for (unsigned int t = 0; t < threads; ++t) {
+            aNotBetter += notBetter[t];
+            aNotWorse += notWorse[t];
+        }
+        result.pValue = std::min(1.0, 2 * std::min(aNotBetter, aNotWorse) / resamples);
+    } else {
+        result.lowB = result.highB = result.werB;
+        result.pValue = 1;
+    }
+    return result;
+}
@@ -0,0 +1,93 @@
+#include "../include/cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <utility>
+#include <unistd.h>
+
+namespace {
+
+// 64-bit FNV-1a
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+void hash_bytes(std::uint64_t &hash, const std::string &bytes) {
+    for (unsigned char byte : bytes) {
+        hash = (hash ^ byte) * FNV_PRIME;
+    }
+}
+
+void hash_words(std::uint64_t &hash, const std::vector<std::string> &words) {
+    for (const std::string &word : words) {
+        hash_bytes(hash, word);
+        hash = (hash ^ '\n') * FNV_PRIME;   // words never contain whitespace, so this separates them
+    }
+}
+
+} // namespace
+
+ResultCache::ResultCache(std::string directory) : directory(std::move(directory)) {
+    std::error_code error;
+    std::filesystem::create_directories(this->directory, error);
+    if (error) {
+        std::cerr << "Warning: Unable to create cache directory " << this->directory << ": " << error.message() << std::endl;
+    }
+}
+
+std::uint64_t ResultCache::make_key(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                                    const std::string &settings) {
+    std::uint64_t hash = FNV_OFFSET;
+    hash_bytes(hash, settings);
+    hash = (hash ^ 0x1e) * FNV_PRIME;
+    hash_words(hash, original);
+    hash = (hash ^ 0x1f) * FNV_PRIME;
+    hash_words(hash, target);
+    return hash;
+}
+
+std::optional<PairScore> ResultCache::lookup(std::uint64_t key, std::size_t originalWords, std::size_t targetWords) const {
+    std::ifstream file(path_for(key));
+    PairScore result;
+    if (!(file >> result.distance >> result.originalWords >> result.targetWords)) {
+        return std::nullopt;
+    }
+    // The word counts guard against a (very unlikely) hash collision
+    if (result.originalWords != originalWords || result.targetWords != targetWords) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+void ResultCache::store(std::uint64_t key, const PairScore &result) const {
+    // Write to a temporary file and rename it, so concurrent runs never read a partial entry.
+    // mkstemp gives every writer its own temporary file, even for the same key.
+    std::string path = path_for(key);
+    std::string temporary = path + ".XXXXXX";
+    int descriptor = mkstemp(temporary.data());
+    if (descriptor < 0) {
+        return;
+    }
+    std::FILE *file = fdopen(descriptor, "w");
+    if (!file) {
+        close(descriptor);
+        std::remove(temporary.c_str());
+        return;
+    }
+    bool written = std::fprintf(file, "%.17g %zu %zu\n", result.distance, result.originalWords, result.targetWords) > 0;
+    written = std::fclose(file) == 0 && written;
+    std::error_code error;
+    if (written) {
+        std::filesystem::rename(temporary, path, error);
+    }
+    if (!written || error) {
+        std::remove(temporary.c_str());
+    }
+}
+
+std::string ResultCache::path_for(std::uint64_t key) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.wer", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(directory) / name).string();
+}
@@ -0,0 +1,128 @@
+#include "../include/cost_policy.h"
+#include "../include/helper.h"
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+std::string fold_accents(const std::string &word) {
+    // Base letters for U+00C0..U+00FF, which UTF-8 encodes as 0xC3 followed by 0x80..0xBF
+    static const char latin1[] = "aaaaaaaceeeeiiiidnooooo*ouuuuyts"
+                                 "aaaaaaaceeeeiiiidnooooo/ouuuuyty";
+    std::string folded;
+    folded.reserve(word.size());
+    for (std::size_t i = 0; i < word.size(); ++i) {
+        unsigned char byte = word[i];
+        if (byte == 0xC3 && i + 1 < word.size()) {
+            unsigned char next = word[i + 1];
+            if (next >= 0x80 && next <= 0xBF) {
+                char base = latin1[next - 0x80];
+                if (base != '*' && base != '/') {
+                    folded += base;
+                    ++i;
+                    continue;
+                }
+            }
+        }
+        folded += static_cast<char>(byte);
+    }
+    return folded;
+}
+
+// Function to parse a whole token as a finite, non-negative cost
+static bool parse_cost(const std::string &text, float &cost) {
+    const char *end = text.data() + text.size();
+    auto [next, error] = std::from_chars(text.data(), end, cost);
+    return !text.empty() && error == std::errc() && next == end && std::isfinite(cost) && cost >= 0;
+}
+
+std::optional<CostTable> CostTable::load(const std::string &filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        return std::nullopt;
+    }
+
+    CostTable table;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string first, second, third;
+        iss >> first >> second;
+        float *defaultCost = first == "insertion"      ? &table.insertion
+                             : first == "deletion"     ? &table.deletion
+                             : first == "substitution" ? &table.substitution
+                             : first == "accent"       ? &table.accent
+                                                       : nullptr;
+        if (!defaultCost) {
+            iss >> third;
+        }
+        // A typo such as "insertion 1,5" must not leave a cost at 0, which would make that edit free
+        const std::string &value = defaultCost ? second : third;
+        float cost = 0;
+        if (!parse_cost(value, cost)) {
+            std::cerr << "Error: invalid cost \"" << value << "\" on line " << lineNumber << " in " << filename
+                      << ", expected a number of at least 0" << std::endl;
+            return std::nullopt;
+        }
+        if (defaultCost) {
+            *defaultCost = cost;
+            continue;
+        }
+
+        // Pair entries are written like the transcriptions and cleaned the same way
+        clean_string(first);
+        clean_string(second);
+        table.pairs.emplace_back(std::move(first), std::move(second), cost);
+    }
+    return table;
+}
+
+std::string CostTable::describe() const {
+    std::ostringstream description;
+    description.precision(9);
+    description << insertion << ' ' << deletion << ' ' << substitution << ' ' << accent;
+    for (const auto &[first, second, cost] : pairs) {
+        description << '\n' << first << ' ' << second << ' ' << cost;
+    }
+    return description.str();
+}
+
+WeightedCost WeightedCost::bind(const CostTable &table, const std::vector<std::string> &vocabulary) {
+    WeightedCost policy;
+    policy.insertionCost = table.insertion;
+    policy.deletionCost = table.deletion;
+    policy.substitutionCost = table.substitution;
+    policy.accentCost = table.accent;
+
+    std::unordered_map<std::string, int> ids;
+    for (std::size_t id = 0; id < vocabulary.size(); ++id) {
+        ids.emplace(vocabulary[id], static_cast<int>(id));
+    }
+
+    // Words sharing an accent-free spelling share a folded id
+    std::unordered_map<std::string, int> foldedIds;
+    policy.foldedIds.reserve(vocabulary.size());
+    for (const std::string &word : vocabulary) {
+        policy.foldedIds.push_back(foldedIds.emplace(fold_accents(word), static_cast<int>(foldedIds.size())).first->second);
+    }
+    policy.hasPairCost.assign(vocabulary.size(), 0);
+
+    for (const auto &[first, second, cost] : table.pairs) {
+        auto a = ids.find(first);
+        auto b = ids.find(second);
+        if (a == ids.end() || b == ids.end()) {
+            continue; // one of the words never occurs, the entry cannot matter
+        }
+        policy.pairCosts[pair_key(a->second, b->second)] = cost;
+        policy.hasPairCost[a->second] = 1;
+        policy.hasPairCost[b->second] = 1;
+    }
+    return policy;
+}
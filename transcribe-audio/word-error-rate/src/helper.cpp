@@ -1,9 +1,16 @@
 #include "../include/helper.h"
+#include "../include/cost_policy.h"
+#include "../include/input_stream.h"
+#include "../include/stats.h"
+#include "subtitle.h"
 #include <algorithm>
 #include <cctype>
-#include <fstream>
 #include <iostream>
 #include <sstream>
+#include <unordered_map>
+
+constexpr std::size_t READ_CHUNK_SIZE = 64 * 1024;
+constexpr std::size_t FORMAT_DETECTION_SIZE = 512;
 
 void clean_string(std::string &str) {
     // Convert the string to lowercase
@@ -24,31 +31,38 @@ std::vector<std::string> split_into_words(const std::string &str) {
 }
 
 int levenshtein_distance(const std::vector<std::string> &original, const std::vector<std::string> &target) {
-    // Get the lengths of the two strings
-    int m = original.size();
-    int n = target.size();
+    // Compare integer ids instead of strings inside the DP loop
+    std::vector<int> originalIds, targetIds;
+    intern_words(original, target, originalIds, targetIds);
 
-    // Create a 2D vector to store the distances
-    std::vector<std::vector<int>> dp(m + 1, std::vector<int>(n + 1, 0));
+    // Return the Levenshtein distance
+    return edit_distance<UnitCost>(originalIds, targetIds);
+}
 
-    // Initialize the first row and column
-    for (int i = 0; i <= m; ++i) {
-        dp[i][0] = i;
+void intern_words(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                  std::vector<int> &originalIds, std::vector<int> &targetIds,
+                  std::vector<std::string> *vocabulary) {
+    std::unordered_map<std::string, int> ids;
+    originalIds.clear();
+    targetIds.clear();
+    originalIds.reserve(original.size());
+    targetIds.reserve(target.size());
+    for (const std::string &word : original) {
+        originalIds.push_back(ids.emplace(word, static_cast<int>(ids.size())).first->second);
     }
-    for (int j = 0; j <= n; ++j) {
-        dp[0][j] = j;
+    for (const std::string &word : target) {
+        targetIds.push_back(ids.emplace(word, static_cast<int>(ids.size())).first->second);
     }
-
-    // Fill in the rest of the matrix
-    for (int i = 1; i <= m; ++i) {
-        for (int j = 1; j <= n; ++j) {
-            int cost = original[i - 1] == target[j - 1] ? 0 : 1;
-            dp[i][j] = std::min({dp[i - 1][j] + 1, dp[i][j - 1] + 1, dp[i - 1][j - 1] + cost});
+    if (vocabulary) {
+        vocabulary->assign(ids.size(), std::string());
+        for (const auto &[word, id] : ids) {
+            (*vocabulary)[id] = word;
         }
     }
+}
 
-    // Return the Levenshtein distance
-    return dp[m][n];
+float wer_from_distance(double distance, std::size_t originalWords) {
+    return static_cast<float>(distance) * 100 / originalWords;
 }
 
 float calculate_wer(const std::vector<std::string> &original, const std::vector<std::string> &target) {
@@ -56,24 +70,75 @@ float calculate_wer(const std::vector<std::string> &original, const std::vector<
     int distance = levenshtein_distance(original, target);
 
     // Calculate the Word Error Rate (WER)
-    float wer = static_cast<float>(distance) * 100 / original.size();
+    float wer = wer_from_distance(distance, original.size());
 
     return wer;
 }
 
-std::vector<std::string> read_transcription_file(const std::string &filename) {
+// Function to clean text read from a transcription. Only this cleaning is timed, so that the
+// cleaning stage is a part of the read stage and not of loading rules or costs.
+static void clean_read_text(std::string &text) {
+    StageTimer timer(&RunStats::cleanNanoseconds);
+    clean_string(text);
+}
+
+std::optional<std::vector<std::string>> read_transcription_file(const std::string &filename) {
+    StageTimer timer(&RunStats::readNanoseconds);
     std::vector<std::string> words;
-    std::ifstream file(filename);
-    if (file.is_open()) {
-        std::string line;
-        while (std::getline(file, line)) {
-            clean_string(line);
-            std::vector<std::string> line_words = split_into_words(line);
-            words.insert(words.end(), line_words.begin(), line_words.end());
+    InputStream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << filename << ": " << file.error() << std::endl;
+        return std::nullopt;
+    }
+
+    // Look at the first bytes, even if a pipe delivers them in several pieces, to recognize subtitles
+    std::vector<char> chunk(READ_CHUNK_SIZE);
+    std::size_t count = 0;
+    for (std::size_t got = 1; got > 0 && count < FORMAT_DETECTION_SIZE; count += got) {
+        got = file.read(chunk.data() + count, chunk.size() - count);
+    }
+
+    // SRT, WebVTT and bracketed transcriptions are scored on the text of their cues only
+    subtitle::Format format = subtitle::detect_format(std::string_view(chunk.data(), count));
+    if (format != subtitle::Format::Unknown) {
+        subtitle::Parser parser(format, [&words](const subtitle::Cue &cue) {
+            std::string text = cue.text;
+            clean_read_text(text);
+            std::vector<std::string> cue_words = split_into_words(text);
+            words.insert(words.end(), cue_words.begin(), cue_words.end());
+        });
+        for (; count > 0; count = file.read(chunk.data(), chunk.size())) {
+            parser.feed(std::string_view(chunk.data(), count));
+        }
+        parser.finish();
+        if (parser.malformed_count() > 0) {
+            std::cerr << "Warning: skipped " << parser.malformed_count() << " malformed lines in " << filename << std::endl;
         }
-        file.close();
     } else {
-        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        // Cleaning works character by character, so the stream can be cut anywhere outside a word:
+        // each chunk is processed up to its last whitespace and only the trailing partial word is
+        // carried over to the next one
+        std::string pending;
+        for (; count > 0; count = file.read(chunk.data(), chunk.size())) {
+            pending.append(chunk.data(), count);
+            std::size_t boundary = pending.find_last_of(" \t\r\n");
+            if (boundary == std::string::npos) {
+                continue;
+            }
+            std::string complete = pending.substr(0, boundary + 1);
+            pending.erase(0, boundary + 1);
+            clean_read_text(complete);
+            std::vector<std::string> chunk_words = split_into_words(complete);
+            words.insert(words.end(), chunk_words.begin(), chunk_words.end());
+        }
+        clean_read_text(pending);
+        std::vector<std::string> last_words = split_into_words(pending);
+        words.insert(words.end(), last_words.begin(), last_words.end());
+    }
+
+    if (!file.error().empty()) {
+        std::cerr << "Error: Unable to read file " << filename << ": " << file.error() << std::endl;
+        return std::nullopt;
     }
     return words;
-}
\ No newline at end of file
+}
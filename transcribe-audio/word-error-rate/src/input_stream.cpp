@@ -0,0 +1,186 @@
+#include "../include/input_stream.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+#ifdef WER_WITH_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr std::size_t INPUT_CHUNK_SIZE = 64 * 1024;
+
+bool starts_with(const std::vector<char> &bytes, std::size_t size, const unsigned char *magic, std::size_t magicSize) {
+    return size >= magicSize && std::memcmp(bytes.data(), magic, magicSize) == 0;
+}
+
+} // namespace
+
+struct InputStream::Decoder {
+    z_stream zlib{};
+    bool zlibReady = false;
+    bool frameComplete = false;     // the last gzip member or zstd frame reached its end
+    bool flushPending = false;      // zstd filled the output and may still hold decoded data
+#ifdef WER_WITH_ZSTD
+    ZSTD_DStream *zstd = nullptr;
+#endif
+
+    ~Decoder() {
+        if (zlibReady) {
+            inflateEnd(&zlib);
+        }
+#ifdef WER_WITH_ZSTD
+        ZSTD_freeDStream(zstd);
+#endif
+    }
+};
+
+InputStream::InputStream(const std::string &path)
+    : fd(-1), ownsFd(false), endOfInput(false), format(Format::Plain),
+      input(INPUT_CHUNK_SIZE), inputBegin(0), inputEnd(0), decoder(std::make_unique<Decoder>()) {
+    if (path == "-") {
+        fd = STDIN_FILENO;
+    } else {
+        fd = ::open(path.c_str(), O_RDONLY);
+        ownsFd = true;
+        if (fd < 0) {
+            errorMessage = std::strerror(errno);
+            return;
+        }
+    }
+
+    // Peek at the first chunk to recognize compressed input by its magic number
+    fill_input();
+    static const unsigned char gzipMagic[] = {0x1f, 0x8b};
+    static const unsigned char zstdMagic[] = {0x28, 0xb5, 0x2f, 0xfd};
+    if (starts_with(input, inputEnd, gzipMagic, sizeof(gzipMagic))) {
+        format = Format::Gzip;
+        // 15 + 32: maximum window, accept both gzip and zlib headers
+        if (inflateInit2(&decoder->zlib, 15 + 32) != Z_OK) {
+            errorMessage = "unable to initialize gzip decompression";
+            return;
+        }
+        decoder->zlibReady = true;
+    } else if (starts_with(input, inputEnd, zstdMagic, sizeof(zstdMagic))) {
+        format = Format::Zstd;
+#ifdef WER_WITH_ZSTD
+        decoder->zstd = ZSTD_createDStream();
+        ZSTD_initDStream(decoder->zstd);
+#else
+        errorMessage = "zstd input needs a build with ZSTD=1";
+#endif
+    }
+}
+
+InputStream::~InputStream() {
+    if (ownsFd && fd >= 0) {
+        ::close(fd);
+    }
+}
+
+bool InputStream::fill_input() {
+    // Move the unconsumed bytes to the front, then top the chunk up from the descriptor
+    if (inputBegin > 0) {
+        std::memmove(input.data(), input.data() + inputBegin, inputEnd - inputBegin);
+        inputEnd -= inputBegin;
+        inputBegin = 0;
+    }
+    while (!endOfInput && inputEnd < input.size()) {
+        ssize_t count = ::read(fd, input.data() + inputEnd, input.size() - inputEnd);
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            if (count < 0) {
+                errorMessage = std::strerror(errno);
+            }
+            endOfInput = true;
+            break;
+        }
+        inputEnd += count;
+        break;  // a pipe delivers what it has, do not wait for a full chunk
+    }
+    return inputEnd > inputBegin;
+}
+
+std::size_t InputStream::read_plain(char *buffer, std::size_t size) {
+    if (inputBegin == inputEnd && !fill_input()) {
+        return 0;
+    }
+    std::size_t count = std::min(size, inputEnd - inputBegin);
+    std::memcpy(buffer, input.data() + inputBegin, count);
+    inputBegin += count;
+    return count;
+}
+
+// Function to fail a compressed stream whose input ends inside a gzip member or zstd frame,
+// which would otherwise look like a clean end of file
+void InputStream::report_truncation(const char *compression) {
+    if (errorMessage.empty() && !decoder->frameComplete) {
+        errorMessage = std::string("truncated ") + compression + " data";
+    }
+}
+
+std::size_t InputStream::read(char *buffer, std::size_t size) {
+    if (!is_open() || !errorMessage.empty()) {
+        return 0;
+    }
+
+    switch (format) {
+    case Format::Plain:
+        return read_plain(buffer, size);
+
+    case Format::Gzip: {
+        z_stream &zlib = decoder->zlib;
+        zlib.next_out = reinterpret_cast<Bytef *>(buffer);
+        zlib.avail_out = static_cast<uInt>(size);
+        while (zlib.avail_out == size) {
+            if (inputBegin == inputEnd && !fill_input()) {
+                report_truncation("gzip");
+                break;
+            }
+            zlib.next_in = reinterpret_cast<Bytef *>(input.data() + inputBegin);
+            zlib.avail_in = static_cast<uInt>(inputEnd - inputBegin);
+            int status = inflate(&zlib, Z_NO_FLUSH);
+            inputBegin = inputEnd - zlib.avail_in;
+            decoder->frameComplete = status == Z_STREAM_END;
+            if (status == Z_STREAM_END) {
+                inflateReset(&zlib);    // concatenated gzip members continue the stream
+            } else if (status != Z_OK && status != Z_BUF_ERROR) {
+                errorMessage = zlib.msg ? zlib.msg : "corrupt gzip data";
+                break;
+            }
+        }
+        return size - zlib.avail_out;
+    }
+
+    case Format::Zstd: {
+#ifdef WER_WITH_ZSTD
+        ZSTD_outBuffer out = {buffer, size, 0};
+        while (out.pos == 0) {
+            // Data held back by the decoder is flushed with an empty input before reading more
+            if (inputBegin == inputEnd && !decoder->flushPending && !fill_input()) {
+                report_truncation("zstd");
+                break;
+            }
+            ZSTD_inBuffer in = {input.data() + inputBegin, inputEnd - inputBegin, 0};
+            std::size_t status = ZSTD_decompressStream(decoder->zstd, &out, &in);
+            inputBegin += in.pos;
+            decoder->frameComplete = status == 0;   // 0 once a frame is fully decoded and flushed
+            decoder->flushPending = out.pos == out.size;
+            if (ZSTD_isError(status)) {
+                errorMessage = ZSTD_getErrorName(status);
+                break;
+            }
+        }
+        return out.pos;
+#else
+        return 0;
+#endif
+    }
+    }
+    return 0;
+}
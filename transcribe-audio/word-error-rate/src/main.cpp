@@ -1,27 +1,376 @@
 #include "../include/helper.h"
+#include "../include/bitparallel.h"
+#include "../include/bootstrap.h"
+#include "../include/cache.h"
+#include "../include/cost_policy.h"
+#include "../include/normalizer.h"
+#include "../include/scoring.h"
+#include "../include/stats.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <thread>
 
-int main()
+static void print_usage(const char *program)
 {
-    std::string originalFile, targetFile;
-    std::cout << "Enter the path to the original transcription file: ";
-    std::cin >> originalFile;
-    std::cout << "Enter the path to the target transcription file: ";
-    std::cin >> targetFile;
+    std::cerr << "Usage: " << program << " [--anchored | --wavefront | --costs FILE] [--normalize RULES] [--cache DIR] [--threads N] [--stats[=json]] [original target]" << std::endl
+              << "       " << program << " --multi [scoring options] reference hypothesis..." << std::endl
+              << "       " << program << " --corpus LIST [--bootstrap N] [--seed S] [scoring options]" << std::endl
+              << "  --anchored   split the alignment at unique common words and solve the pieces in parallel;" << std::endl
+              << "               never below the exact distance, and equal to it only when the anchors lie on an optimal alignment" << std::endl
+              << "  --wavefront  exact distance, with the DP matrix split into tiles computed in parallel" << std::endl
+              << "  --costs FILE weighted edit distance with the insertion/deletion/substitution costs in FILE (not with --anchored or --wavefront)" << std::endl
+              << "  --normalize RULES rewrite numbers, contractions, fillers, ... in both files before scoring" << std::endl
+              << "  --cache DIR  reuse results of earlier runs on the same normalized inputs and settings" << std::endl
+              << "  --threads N  number of worker threads (default: all cores)" << std::endl
+              << "  --multi      score several hypotheses against one reference, loaded once, concurrently" << std::endl
+              << "  --corpus LIST score every \"reference hypothesis [hypothesisB]\" line of LIST as one corpus" << std::endl
+              << "  --bootstrap N number of bootstrap resamples for the corpus confidence intervals (default: 1000)" << std::endl
+              << "  --seed S     random seed of the bootstrap (default: 1)" << std::endl
+              << "  --stats      report stage timings, word and DP cell counts, peak memory and allocations on standard error" << std::endl
+              << "  --stats=json the same report as one JSON object" << std::endl
+              << "Without file arguments the paths are read from standard input." << std::endl;
+}
+
+// Scores every line of a corpus list and prints the corpus WER with bootstrap confidence intervals
+static int run_corpus(const std::string &listFile, const ScoringOptions &options, const Normalizer *normalizer,
+                      const ResultCache *cache, int resamples, std::uint64_t seed)
+{
+    std::ifstream list(listFile);
+    if (!list.is_open())
+    {
+        std::cerr << "Error: Unable to open file " << listFile << std::endl;
+        return 1;
+    }
+
+    std::vector<UtteranceCounts> utterances;
+    bool paired = false;
+    std::string line;
+    while (std::getline(list, line))
+    {
+        std::istringstream iss(line);
+        std::string reference, hypothesis, hypothesisB;
+        if (!(iss >> reference >> hypothesis))
+        {
+            continue;
+        }
+        iss >> hypothesisB;
+        if (utterances.empty())
+        {
+            paired = !hypothesisB.empty();
+        }
+        else if (paired == hypothesisB.empty())
+        {
+            std::cerr << "Error: every line of " << listFile << " needs the same number of hypotheses" << std::endl;
+            return 1;
+        }
+
+        // A missing hypothesis must not pass for a perfect one, so any unreadable file stops the run
+        std::optional<PairScore> scoreA = score_files(reference, hypothesis, options, normalizer, cache);
+        std::optional<PairScore> scoreB;
+        if (paired)
+        {
+            scoreB = score_files(reference, hypothesisB, options, normalizer, cache);
+        }
+        if (!scoreA || (paired && !scoreB))
+        {
+            std::cerr << "Error: unable to score line " << utterances.size() + 1 << " of " << listFile << std::endl;
+            return 1;
+        }
+        utterances.push_back({scoreA->distance, paired ? scoreB->distance : 0, scoreA->originalWords});
+    }
+
+    if (utterances.empty())
+    {
+        std::cerr << "Error: no transcription pairs listed in " << listFile << std::endl;
+        return 1;
+    }
+
+    BootstrapResult result = bootstrap_wer(utterances, paired, resamples, options.threads, seed);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Utterances: " << utterances.size() << std::endl;
+    std::cout << "Corpus WER" << (paired ? " (A)" : "") << ": " << result.werA << " % (95% CI "
+              << result.lowA << " - " << result.highA << " %)" << std::endl;
+    if (paired)
+    {
+        std::cout << "Corpus WER (B): " << result.werB << " % (95% CI "
+                  << result.lowB << " - " << result.highB << " %)" << std::endl;
+        std::cout << std::setprecision(4) << "Paired bootstrap p-value: " << result.pValue << std::endl;
+    }
+    return 0;
+}
+
+// Scores several hypotheses against a single reference that is read, normalized and
+// preprocessed only once, spreading the hypotheses over a pool of threads
+static int run_multi(const std::vector<std::string> &files, const ScoringOptions &options, const Normalizer *normalizer,
+                     const ResultCache *cache)
+{
+    std::optional<std::vector<std::string>> referenceRead = read_transcription_file(files[0]);
+    if (!referenceRead)
+    {
+        return 1;
+    }
+    std::vector<std::string> reference = std::move(*referenceRead);
+    if (normalizer)
+    {
+        reference = normalizer->apply(reference);
+    }
+    if (reference.empty())
+    {
+        std::cerr << "Error: the reference transcription " << files[0] << " is empty" << std::endl;
+        return 1;
+    }
+
+    // The bit-vector tables answer unit-cost distances; other settings go through the usual kernels
+    bool bitParallel = !options.costs && options.algorithm != Algorithm::Anchored;
+    BitParallelReference preprocessed(bitParallel ? reference : std::vector<std::string>());
+    std::string settings = describe_options(options);
+    ScoringOptions perHypothesis = options;
+    perHypothesis.threads = 1;  // the parallelism is across hypotheses
+
+    std::size_t hypothesisCount = files.size() - 1;
+    std::vector<std::optional<PairScore>> scores(hypothesisCount);
+    std::atomic<std::size_t> next{0};
+    auto worker = [&]() {
+        for (std::size_t k = next++; k < hypothesisCount; k = next++)
+        {
+            std::optional<std::vector<std::string>> hypothesisRead = read_transcription_file(files[k + 1]);
+            if (!hypothesisRead)
+            {
+                continue;   // reported by the reader, the run fails at the end
+            }
+            std::vector<std::string> hypothesis = std::move(*hypothesisRead);
+            if (normalizer)
+            {
+                hypothesis = normalizer->apply(hypothesis);
+            }
+            record_stat(&RunStats::pairs, 1);
+            record_stat(&RunStats::originalWords, reference.size());
+            record_stat(&RunStats::targetWords, hypothesis.size());
+
+            std::uint64_t key = cache ? ResultCache::make_key(reference, hypothesis, settings) : 0;
+            if (cache)
+            {
+                if (std::optional<PairScore> cached = cache->lookup(key, reference.size(), hypothesis.size()))
+                {
+                    scores[k] = *cached;
+                    record_stat(&RunStats::cacheHits, 1);
+                    continue;
+                }
+            }
+
+            double distance = bitParallel ? preprocessed.distance(hypothesis)
+                                          : compute_distance(reference, hypothesis, perHypothesis);
+            scores[k] = PairScore{distance, reference.size(), hypothesis.size()};
+            if (cache)
+            {
+                cache->store(key, *scores[k]);
+            }
+        }
+    };
+
+    unsigned int threads = std::min<std::size_t>(options.threads, hypothesisCount);
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t)
+    {
+        pool.emplace_back(worker);
+    }
+    worker();
+    for (std::thread &thread : pool)
+    {
+        thread.join();
+    }
+
+    std::cout << std::setprecision(4);
+    int status = 0;
+    for (std::size_t k = 0; k < hypothesisCount; ++k)
+    {
+        if (!scores[k])
+        {
+            std::cout << files[k + 1] << ": error" << std::endl;
+            status = 1;
+            continue;
+        }
+        std::cout << files[k + 1] << ": " << wer_from_distance(scores[k]->distance, scores[k]->originalWords) << " %" << std::endl;
+    }
+    return status;
+}
+
+// Prints the --stats report, when one was requested, and passes the exit status through
+static int finish(int status, bool stats, bool json)
+{
+    if (stats)
+    {
+        print_stats(std::cerr, json);
+    }
+    return status;
+}
 
-    // Read the transcription files
-    std::vector<std::string> originalWords = read_transcription_file(originalFile);
-    std::vector<std::string> targetWords = read_transcription_file(targetFile);
+int main(int argc, char *argv[])
+{
+    ScoringOptions options;
+    options.threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string costsFile;
+    std::string rulesFile;
+    std::string cacheDirectory;
+    std::string corpusFile;
+    bool multi = false;
+    int resamples = 1000;
+    std::uint64_t seed = 1;
+    bool stats = false;
+    bool statsJson = false;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--anchored") == 0)
+        {
+            options.algorithm = Algorithm::Anchored;
+        }
+        else if (std::strcmp(argv[i], "--wavefront") == 0)
+        {
+            options.algorithm = Algorithm::Wavefront;
+        }
+        else if (std::strcmp(argv[i], "--costs") == 0 && i + 1 < argc)
+        {
+            costsFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--normalize") == 0 && i + 1 < argc)
+        {
+            rulesFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--cache") == 0 && i + 1 < argc)
+        {
+            cacheDirectory = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+        {
+            options.threads = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--multi") == 0)
+        {
+            multi = true;
+        }
+        else if (std::strcmp(argv[i], "--corpus") == 0 && i + 1 < argc)
+        {
+            corpusFile = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--bootstrap") == 0 && i + 1 < argc)
+        {
+            resamples = std::max(0, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0 || std::strcmp(argv[i], "--stats=json") == 0)
+        {
+            stats = true;
+            statsJson = argv[i][7] == '=';
+            enable_stats();
+        }
+        else if (argv[i][0] == '-' && argv[i][1] == '-')
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        else
+        {
+            files.push_back(argv[i]);
+        }
+    }
 
-    if (originalWords.empty() || targetWords.empty())
+    // The weighted costs only exist for the plain DP kernel
+    if (!costsFile.empty() && options.algorithm != Algorithm::Exact)
     {
-        std::cerr << "Error: one or both of the transcription files are empty" << std::endl;
+        std::cerr << "Error: --costs cannot be combined with --anchored or --wavefront" << std::endl;
+        print_usage(argv[0]);
         return 1;
     }
+    std::optional<CostTable> costs;
+    if (!costsFile.empty())
+    {
+        costs = CostTable::load(costsFile);
+        if (!costs)
+        {
+            return 1;
+        }
+        options.costs = &*costs;
+    }
+
+    std::unique_ptr<Normalizer> normalizer;
+    if (!rulesFile.empty())
+    {
+        std::optional<Normalizer> rules = Normalizer::load(rulesFile);
+        if (!rules)
+        {
+            return 1;
+        }
+        normalizer = std::make_unique<Normalizer>(std::move(*rules));
+    }
+    std::unique_ptr<ResultCache> cache;
+    if (!cacheDirectory.empty())
+    {
+        cache = std::make_unique<ResultCache>(cacheDirectory);
+    }
+
+    if (!corpusFile.empty())
+    {
+        return finish(run_corpus(corpusFile, options, normalizer.get(), cache.get(), resamples, seed), stats, statsJson);
+    }
+
+    if (multi)
+    {
+        if (files.size() < 2)
+        {
+            print_usage(argv[0]);
+            return 1;
+        }
+        return finish(run_multi(files, options, normalizer.get(), cache.get()), stats, statsJson);
+    }
+
+    std::string originalFile, targetFile;
+    if (files.size() == 2)
+    {
+        originalFile = files[0];
+        targetFile = files[1];
+    }
+    else if (files.empty())
+    {
+        std::cout << "Enter the path to the original transcription file: ";
+        std::cin >> originalFile;
+        std::cout << "Enter the path to the target transcription file: ";
+        std::cin >> targetFile;
+    }
+    else
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Read, normalize and score the transcription files
+    std::optional<PairScore> score = score_files(originalFile, targetFile, options, normalizer.get(), cache.get());
+    if (!score)
+    {
+        return finish(1, stats, statsJson);
+    }
+
+    // The WER is relative to the original, without words it is undefined; an empty target is 100 %
+    if (score->originalWords == 0)
+    {
+        std::cerr << "Error: the original transcription is empty" << std::endl;
+        return finish(1, stats, statsJson);
+    }
 
     // Calculate the Word Error Rate (WER)
-    float wer =  calculate_wer(originalWords, targetWords);
+    float wer = wer_from_distance(score->distance, score->originalWords);
 
     std::cout << std::setprecision(4) << "The Word Error Rate (WER) is: " << wer << " %" << std::endl;
+    return finish(0, stats, statsJson);
 }
@@ -0,0 +1,103 @@
+#include "../include/normalizer.h"
+#include "../include/helper.h"
+#include "../include/stats.h"
+#include <fstream>
+#include <iostream>
+
+std::optional<Normalizer> Normalizer::load(const std::string &filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Unable to open file " << filename << std::endl;
+        return std::nullopt;
+    }
+
+    Normalizer normalizer;
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::size_t arrow = line.find("=>");
+        if (arrow == std::string::npos) {
+            std::cerr << "Warning: ignoring malformed line " << lineNumber << " in " << filename << std::endl;
+            continue;
+        }
+
+        // Both sides go through the same cleaning as the transcriptions, so rules can be
+        // written naturally ("don't => do not") and still match the cleaned words
+        std::string pattern = line.substr(0, arrow);
+        std::string replacement = line.substr(arrow + 2);
+        clean_string(pattern);
+        clean_string(replacement);
+        std::vector<std::string> patternWords = split_into_words(pattern);
+        if (patternWords.empty()) {
+            std::cerr << "Warning: ignoring empty pattern on line " << lineNumber << " in " << filename << std::endl;
+            continue;
+        }
+        // "percent => %" would silently delete the word, only an empty right-hand side may do that
+        std::vector<std::string> replacementWords = split_into_words(replacement);
+        if (replacementWords.empty() && !split_into_words(line.substr(arrow + 2)).empty()) {
+            std::cerr << "Warning: ignoring rule on line " << lineNumber << " in " << filename
+                      << ", its right-hand side has no words left after cleaning" << std::endl;
+            continue;
+        }
+        normalizer.add_rule(patternWords, replacementWords);
+    }
+    return normalizer;
+}
+
+void Normalizer::add_rule(const std::vector<std::string> &pattern, const std::vector<std::string> &replacement) {
+    int node = 0;
+    for (const std::string &word : pattern) {
+        auto it = nodes[node].children.find(word);
+        if (it == nodes[node].children.end()) {
+            nodes.emplace_back();
+            it = nodes[node].children.emplace(word, static_cast<int>(nodes.size()) - 1).first;
+        }
+        node = it->second;
+    }
+    if (nodes[node].rule == -1) {
+        nodes[node].rule = static_cast<int>(replacements.size());
+        replacements.push_back(replacement);
+    } else {
+        replacements[nodes[node].rule] = replacement; // later rules override earlier ones
+    }
+}
+
+std::vector<std::string> Normalizer::apply(const std::vector<std::string> &words) const {
+    StageTimer timer(&RunStats::normalizeNanoseconds);
+    std::vector<std::string> normalized;
+    normalized.reserve(words.size());
+
+    std::size_t i = 0;
+    while (i < words.size()) {
+        // Walk the trie as far as the words allow, remembering the longest complete pattern
+        int node = 0;
+        int matchedRule = -1;
+        std::size_t matchedLength = 0;
+        for (std::size_t k = i; k < words.size(); ++k) {
+            auto it = nodes[node].children.find(words[k]);
+            if (it == nodes[node].children.end()) {
+                break;
+            }
+            node = it->second;
+            if (nodes[node].rule != -1) {
+                matchedRule = nodes[node].rule;
+                matchedLength = k - i + 1;
+            }
+        }
+
+        if (matchedRule == -1) {
+            normalized.push_back(words[i]);
+            ++i;
+        } else {
+            const std::vector<std::string> &replacement = replacements[matchedRule];
+            normalized.insert(normalized.end(), replacement.begin(), replacement.end());
+            i += matchedLength;
+        }
+    }
+    return normalized;
+}
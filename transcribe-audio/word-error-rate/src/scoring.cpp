@@ -0,0 +1,81 @@
+#include "../include/scoring.h"
+#include "../include/anchors.h"
+#include "../include/cache.h"
+#include "../include/cost_policy.h"
+#include "../include/helper.h"
+#include "../include/normalizer.h"
+#include "../include/stats.h"
+#include "../include/wavefront.h"
+#include <sstream>
+
+double compute_distance(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                        const ScoringOptions &options) {
+    StageTimer timer(&RunStats::distanceNanoseconds);
+    if (options.costs) {
+        std::vector<int> originalIds, targetIds;
+        std::vector<std::string> vocabulary;
+        intern_words(original, target, originalIds, targetIds, &vocabulary);
+        WeightedCost policy = WeightedCost::bind(*options.costs, vocabulary);
+        return edit_distance(std::span<const int>(originalIds), std::span<const int>(targetIds), policy);
+    }
+
+    // With an empty side every word of the other one is an insertion or a deletion
+    if (original.empty() || target.empty()) {
+        return static_cast<double>(original.size() + target.size());
+    }
+
+    switch (options.algorithm) {
+    case Algorithm::Anchored:
+        return anchored_levenshtein_distance(original, target, options.threads);
+    case Algorithm::Wavefront:
+        return wavefront_levenshtein_distance(original, target, options.threads);
+    case Algorithm::Exact:
+        break;
+    }
+    return levenshtein_distance(original, target);
+}
+
+std::string describe_options(const ScoringOptions &options) {
+    std::ostringstream description;
+    if (options.costs) {
+        description << "costs:" << options.costs->describe();
+    } else if (options.algorithm == Algorithm::Anchored) {
+        description << "anchored";  // may differ from the exact distance
+    } else {
+        description << "exact";     // exact and wavefront always agree
+    }
+    return description.str();
+}
+
+std::optional<PairScore> score_files(const std::string &originalFile, const std::string &targetFile,
+                                     const ScoringOptions &options, const Normalizer *normalizer,
+                                     const ResultCache *cache) {
+    std::optional<std::vector<std::string>> originalRead = read_transcription_file(originalFile);
+    std::optional<std::vector<std::string>> targetRead = read_transcription_file(targetFile);
+    if (!originalRead || !targetRead) {
+        return std::nullopt;
+    }
+    std::vector<std::string> original = std::move(*originalRead);
+    std::vector<std::string> target = std::move(*targetRead);
+
+    // Normalize both transcriptions so that formatting differences are not counted as errors
+    if (normalizer) {
+        original = normalizer->apply(original);
+        target = normalizer->apply(target);
+    }
+    record_stat(&RunStats::pairs, 1);
+    record_stat(&RunStats::originalWords, original.size());
+    record_stat(&RunStats::targetWords, target.size());
+
+    if (!cache) {
+        return PairScore{compute_distance(original, target, options), original.size(), target.size()};
+    }
+    std::uint64_t key = ResultCache::make_key(original, target, describe_options(options));
+    if (std::optional<PairScore> cached = cache->lookup(key, original.size(), target.size())) {
+        record_stat(&RunStats::cacheHits, 1);
+        return cached;
+    }
+    PairScore score{compute_distance(original, target, options), original.size(), target.size()};
+    cache->store(key, score);
+    return score;
+}
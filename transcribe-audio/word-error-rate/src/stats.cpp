@@ -0,0 +1,193 @@
+#include "../include/stats.h"
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <sys/resource.h>
+
+std::atomic<bool> statsEnabled{false};
+
+namespace {
+
+std::atomic<std::int64_t> allocations{0};
+const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+double to_milliseconds(std::int64_t nanoseconds) {
+    return nanoseconds / 1e6;
+}
+
+// Function to count one allocation. A run without --stats only pays the relaxed load of the flag,
+// so allocations made before the options are parsed are not counted.
+inline void count_allocation() {
+    if (stats_enabled()) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Function to allocate at an alignment above the default one, aligned_alloc needs a multiple
+// of the alignment as the size
+void *aligned_allocation(std::size_t size, std::align_val_t alignment) noexcept {
+    std::size_t align = static_cast<std::size_t>(alignment);
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + align - 1) / align * align;
+    return std::aligned_alloc(align, rounded);
+}
+
+} // namespace
+
+// Counting replacements of the global allocation functions, in all their plain, array, nothrow
+// and aligned forms, so that every allocation of the program goes through the counter
+void *operator new(std::size_t size) {
+    count_allocation();
+    if (void *pointer = std::malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) {
+    return ::operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    count_allocation();
+    return std::malloc(size ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+    return ::operator new(size, tag);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    count_allocation();
+    if (void *pointer = aligned_allocation(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return ::operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    count_allocation();
+    return aligned_allocation(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept {
+    return ::operator new(size, alignment, tag);
+}
+
+// Everything above comes from malloc or aligned_alloc, so every form of delete is a free
+void operator delete(void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t, const std::nothrow_t &) noexcept {
+    std::free(pointer);
+}
+
+// Function to turn the statistics on for the rest of the run
+void enable_stats() {
+    statsEnabled.store(true, std::memory_order_relaxed);
+}
+
+// Function to access the process-wide counters
+RunStats &run_stats() {
+    static RunStats stats;
+    return stats;
+}
+
+StageTimer::StageTimer(std::atomic<std::int64_t> RunStats::*stage)
+    : counter(stats_enabled() ? &(run_stats().*stage) : nullptr) {
+    if (counter) {
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+StageTimer::~StageTimer() {
+    if (counter) {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        counter->fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                           std::memory_order_relaxed);
+    }
+}
+
+// Function to print the counters, wall time, peak RSS and allocation count
+void print_stats(std::ostream &out, bool json) {
+    const RunStats &stats = run_stats();
+    auto wall = std::chrono::steady_clock::now() - startTime;
+    double wallMs = to_milliseconds(std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count());
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    long peakRssKb = usage.ru_maxrss;  // kilobytes on Linux
+
+    // Reading includes the cleaning of each chunk, and only that cleaning is timed, so the
+    // difference is the reading alone
+    double readMs = to_milliseconds(stats.readNanoseconds - stats.cleanNanoseconds);
+    double cleanMs = to_milliseconds(stats.cleanNanoseconds);
+    double normalizeMs = to_milliseconds(stats.normalizeNanoseconds);
+    double distanceMs = to_milliseconds(stats.distanceNanoseconds);
+
+    if (json) {
+        out << "{\"wall_ms\": " << wallMs
+            << ", \"stages_ms\": {\"read\": " << readMs << ", \"clean\": " << cleanMs
+            << ", \"normalize\": " << normalizeMs << ", \"distance\": " << distanceMs << "}"
+            << ", \"pairs\": " << stats.pairs << ", \"cache_hits\": " << stats.cacheHits
+            << ", \"original_words\": " << stats.originalWords << ", \"target_words\": " << stats.targetWords
+            << ", \"dp_cells\": " << stats.dpCells << ", \"peak_rss_kb\": " << peakRssKb
+            << ", \"allocations\": " << allocations << "}" << std::endl;
+        return;
+    }
+
+    out << "Wall time:         " << wallMs << " ms" << std::endl
+        << "  reading:         " << readMs << " ms" << std::endl
+        << "  cleaning:        " << cleanMs << " ms" << std::endl
+        << "  normalization:   " << normalizeMs << " ms" << std::endl
+        << "  edit distance:   " << distanceMs << " ms" << std::endl
+        << "Pairs scored:      " << stats.pairs << " (" << stats.cacheHits << " from the cache)" << std::endl
+        << "Words:             " << stats.originalWords << " original, " << stats.targetWords << " target" << std::endl
+        << "DP cells:          " << stats.dpCells << std::endl
+        << "Peak RSS:          " << peakRssKb << " KiB" << std::endl
+        << "Heap allocations:  " << allocations << std::endl;
+}
@@ -0,0 +1,80 @@
+#include "../include/wavefront.h"
+#include "../include/helper.h"
+#include "../include/stats.h"
+#include <algorithm>
+#include <barrier>
+#include <thread>
+
+int wavefront_levenshtein_distance(const std::vector<std::string> &original, const std::vector<std::string> &target,
+                                   unsigned int threads, int tileSize) {
+    std::vector<int> originalIds, targetIds;
+    intern_words(original, target, originalIds, targetIds);
+
+    int m = originalIds.size();
+    int n = targetIds.size();
+    record_stat(&RunStats::dpCells, static_cast<std::int64_t>(m) * n);
+    int rowTiles = (m + tileSize - 1) / tileSize;
+    int columnTiles = (n + tileSize - 1) / tileSize;
+    if (rowTiles == 0 || columnTiles == 0) {
+        return std::max(m, n);
+    }
+
+    // Shared state: the last computed row of every column block, the last computed column of
+    // every row block, and for every column block the DP value at the corner below-left of it
+    std::vector<int> top(n + 1), left(m + 1), corner(columnTiles);
+    for (int j = 0; j <= n; ++j) {
+        top[j] = j;
+    }
+    for (int i = 0; i <= m; ++i) {
+        left[i] = i;
+    }
+    for (int bj = 0; bj < columnTiles; ++bj) {
+        corner[bj] = bj * tileSize;
+    }
+
+    auto process_tile = [&](int bi, int bj, std::vector<int> &previous, std::vector<int> &current) {
+        int i0 = bi * tileSize, i1 = std::min(m, i0 + tileSize);
+        int j0 = bj * tileSize, j1 = std::min(n, j0 + tileSize);
+        int width = j1 - j0;
+
+        previous[0] = corner[bj];
+        std::copy(top.begin() + j0 + 1, top.begin() + j1 + 1, previous.begin() + 1);
+        corner[bj] = left[i1]; // read by the tile below once this one is done
+
+        for (int i = i0 + 1; i <= i1; ++i) {
+            current[0] = left[i];
+            int word = originalIds[i - 1];
+            for (int k = 1; k <= width; ++k) {
+                int cost = word == targetIds[j0 + k - 1] ? 0 : 1;
+                current[k] = std::min({previous[k] + 1, current[k - 1] + 1, previous[k - 1] + cost});
+            }
+            left[i] = current[width];
+            std::swap(previous, current);
+        }
+        std::copy(previous.begin() + 1, previous.begin() + width + 1, top.begin() + j0 + 1);
+    };
+
+    threads = std::max(1u, threads);
+    std::barrier diagonalDone(threads);
+    auto worker = [&](unsigned int id) {
+        std::vector<int> previous(tileSize + 1), current(tileSize + 1);
+        for (int diagonal = 0; diagonal < rowTiles + columnTiles - 1; ++diagonal) {
+            int firstRow = std::max(0, diagonal - columnTiles + 1);
+            int lastRow = std::min(rowTiles - 1, diagonal);
+            for (int bi = firstRow + id; bi <= lastRow; bi += threads) {
+                process_tile(bi, diagonal - bi, previous, current);
+            }
+            diagonalDone.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+    worker(0);
+    for (std::thread &thread : pool) {
+        thread.join();
+    }
+    return top[n];
+}
@@ -0,0 +1,140 @@
+#!/bin/sh
+# End-to-end tests of wer-calculator: each case runs the program on small files written to a
+# temporary directory and checks its output and exit status. Run with `make test`.
+
+WER="$(cd "$(dirname "$0")/.." && pwd)/wer-calculator"
+RULES="$(cd "$(dirname "$0")/.." && pwd)/normalization.rules"
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+cd "$WORK" || exit 1
+
+failures=0
+count=0
+
+# expect NAME EXPECTED_STATUS EXPECTED_OUTPUT COMMAND...: standard output must contain the text
+expect() {
+    name=$1 status=$2 text=$3
+    shift 3
+    count=$((count + 1))
+    output=$("$@" 2>/dev/null)
+    actual=$?
+    if [ "$actual" -ne "$status" ] || { [ -n "$text" ] && ! printf '%s\n' "$output" | grep -qF -- "$text"; }; then
+        echo "FAIL: $name (exit $actual, output: $output)"
+        failures=$((failures + 1))
+    fi
+}
+
+printf 'the cat sat on the mat\n' > reference.txt
+printf 'the cat sat on a mat\n' > hypothesis.txt
+: > empty.txt
+
+# Missing and empty files
+expect "missing hypothesis fails" 1 "" "$WER" reference.txt missing.txt
+expect "empty hypothesis is all deletions" 0 "WER) is: 100 %" "$WER" reference.txt empty.txt
+expect "empty original fails" 1 "" "$WER" empty.txt reference.txt
+expect "multi reports empty hypothesis" 0 "empty.txt: 100 %" "$WER" --multi reference.txt empty.txt hypothesis.txt
+expect "multi fails on missing hypothesis" 1 "missing.txt: error" "$WER" --multi reference.txt hypothesis.txt missing.txt
+printf 'reference.txt empty.txt\nreference.txt hypothesis.txt\n' > corpus.list
+expect "corpus counts empty hypothesis" 0 "Corpus WER: 58.33 %" "$WER" --corpus corpus.list --bootstrap 10
+printf 'reference.txt hypothesis.txt\nreference.txt missing.txt\n' > missing.list
+expect "corpus fails on missing hypothesis" 1 "" "$WER" --corpus missing.list
+printf 'the dog sat on the mat\n' > other.txt
+printf 'reference.txt hypothesis.txt other.txt\nreference.txt empty.txt hypothesis.txt\nreference.txt reference.txt other.txt\n' > paired.list
+expect "bootstrap does not depend on threads" 0 "" sh -c 'test "$("$0" $1 --threads 1)" = "$("$0" $1 --threads 4)"' \
+    "$WER" "--corpus paired.list --bootstrap 300 --seed 7"
+
+# Bit-parallel --multi scoring agrees with the exact distance when the reference fills one, two or
+# more 64-word blocks, partly or exactly
+for n in 5 64 65 128 129 200; do
+    seq 1 $n | tr '\n' ' ' > ref$n.txt
+    seq 1 $n | sed -e '1d' -e '64s/.*/x/' -e '65a extra' | tr '\n' ' ' > edit$n.txt
+    { seq $n -1 1; seq 1 7; } | tr '\n' ' ' > reversed$n.txt
+    for hypothesis in edit$n.txt reversed$n.txt empty.txt; do
+        exact=$("$WER" ref$n.txt $hypothesis | sed 's/.*is: //')
+        expect "multi matches exact ($n words, $hypothesis)" 0 "$hypothesis: $exact" \
+            "$WER" --multi ref$n.txt edit$n.txt reversed$n.txt empty.txt
+    done
+done
+
+# Compressed input
+seq 1 20000 | tr '\n' ' ' > numbers.txt
+gzip -c numbers.txt > numbers.txt.gz
+head -c $(($(wc -c < numbers.txt.gz) - 12)) numbers.txt.gz > truncated.txt.gz
+head -c 100 numbers.txt.gz > short.txt.gz
+expect "gzip input is decompressed" 0 "WER) is: 0 %" "$WER" numbers.txt numbers.txt.gz
+expect "concatenated gzip members" 0 "WER) is: 0 %" sh -c "cat numbers.txt.gz numbers.txt.gz > twice.txt.gz && cat numbers.txt numbers.txt > twice.txt && '$WER' twice.txt twice.txt.gz"
+expect "gzip without its trailer fails" 1 "" "$WER" numbers.txt truncated.txt.gz
+expect "gzip cut in the data fails" 1 "" "$WER" numbers.txt short.txt.gz
+
+# Subtitles are scored on their cue text only, with CRLF line endings, a byte order mark, and lines
+# cut by the 64 KiB read chunks or by a pipe that delivers them in pieces
+awk 'BEGIN { for (i = 1; i <= 3000; i++) printf "word%d and more\n", i }' > cues.txt
+awk 'BEGIN { printf "\357\273\277"
+             for (i = 1; i <= 3000; i++) printf "%d\r\n00:00:01,000 --> 00:00:02,500\r\nword%d\r\nand more\r\n\r\n", i, i }' > cues.srt
+awk 'BEGIN { printf "\357\273\277WEBVTT\r\n\r\nNOTE not a cue\r\n\r\n"
+             for (i = 1; i <= 3000; i++) printf "cue-%d\r\n00:01.000 --> 00:02.500 align:start\r\nword%d\r\nand more\r\n\r\n", i, i }' > cues.vtt
+awk 'BEGIN { printf "\357\273\277"
+             for (i = 1; i <= 3000; i++) printf "[00:00:01,000 - 00:00:02,500] word%d and more\r\n", i }' > bracketed.txt
+expect "srt with crlf and bom" 0 "WER) is: 0 %" "$WER" cues.txt cues.srt
+expect "webvtt with crlf and bom" 0 "WER) is: 0 %" "$WER" cues.txt cues.vtt
+expect "bracketed with crlf and bom" 0 "WER) is: 0 %" "$WER" cues.txt bracketed.txt
+expect "srt line cut by a pipe" 0 "WER) is: 0 %" \
+    sh -c '{ head -c 600 cues.srt; sleep 0.2; head -c 699 cues.srt | tail -c +601; sleep 0.2; tail -c +700 cues.srt; } | "$0" cues.txt -' "$WER"
+
+# Anchored alignment agrees with the exact distance when the anchors lie on an optimal alignment
+seq 1 3000 | tr '\n' ' ' > long.txt
+seq 1 3000 | sed -e 's/^500$/five/' -e '/^1700$/d' -e 's/^2500$/2500 extra/' | tr '\n' ' ' > edited.txt
+expect "exact distance of long pair" 0 "WER) is: 0.1 %" "$WER" long.txt edited.txt
+expect "anchored matches exact" 0 "WER) is: 0.1 %" "$WER" --anchored --threads 4 long.txt edited.txt
+
+# Wavefront alignment gives the exact distance, including pairs whose tiles are ragged or that need
+# paths far from the diagonal
+seq 1 3 2000 | tr '\n' ' ' > sparse.txt
+{ seq 1200 1600; seq 1 1199; seq 1601 1900; } | sed 's/^7.*//' | tr '\n' ' ' > moved.txt
+for pair in "long.txt edited.txt" "long.txt sparse.txt" "sparse.txt moved.txt" "moved.txt long.txt"; do
+    expect "wavefront matches exact ($pair)" 0 "" sh -c 'test "$("$0" --wavefront --threads 4 $1)" = "$("$0" $1)"' "$WER" "$pair"
+done
+
+# Normalization rules
+printf 'we were there\n' > were.txt
+printf 'we are there\n' > are.txt
+expect "were is not a contraction" 0 "WER) is: 33.33 %" "$WER" --normalize "$RULES" were.txt are.txt
+printf 'its tail and its paw\n' > its.txt
+expect "possessive its is kept" 0 "WER) is: 0 %" "$WER" --normalize "$RULES" its.txt its.txt
+printf 'i feel ill\n' > ill.txt
+printf 'i feel well\n' > well.txt
+expect "ill is not a contraction" 0 "WER) is: 33.33 %" "$WER" --normalize "$RULES" ill.txt well.txt
+printf "we don't know\n" > dont.txt
+printf 'we do not know\n' > donot.txt
+expect "contractions still expand" 0 "WER) is: 0 %" "$WER" --normalize "$RULES" dont.txt donot.txt
+printf 'percent => %%\nseventy => 70\n' > punctuation.rules
+printf 'seventy percent\n' > percent.txt
+printf '70\n' > seventy.txt
+expect "punctuation-only replacement is rejected" 0 "WER) is: 50 %" "$WER" --normalize punctuation.rules percent.txt seventy.txt
+expect "missing rules file fails" 1 "" "$WER" --normalize missing.rules were.txt are.txt
+
+# Weighted costs
+printf 'insertion 1\ndeletion 1\nsubstitution 1\ntwo too 0.25\n' > homophones.costs
+printf 'i have two cats\n' > two.txt
+printf 'i have too cats\n' > too.txt
+expect "pair cost is applied" 0 "WER) is: 6.25 %" "$WER" --costs homophones.costs two.txt too.txt
+expect "costs with anchored is rejected" 1 "" "$WER" --costs homophones.costs --anchored two.txt too.txt
+expect "costs with wavefront is rejected" 1 "" "$WER" --costs homophones.costs --wavefront two.txt too.txt
+printf 'insertion 1,5\n' > comma.costs
+expect "malformed default cost fails" 1 "" "$WER" --costs comma.costs two.txt too.txt
+printf 'deletion -1\n' > negative.costs
+expect "negative default cost fails" 1 "" "$WER" --costs negative.costs two.txt too.txt
+printf 'two too abc\n' > pair.costs
+expect "malformed pair cost fails" 1 "" "$WER" --costs pair.costs two.txt too.txt
+printf '# defaults\naccent 0.5   # with a comment\ntwo too 0.25\n' > commented.costs
+expect "comments after a cost are allowed" 0 "WER) is: 6.25 %" "$WER" --costs commented.costs two.txt too.txt
+expect "missing costs file fails" 1 "" "$WER" --costs missing.costs two.txt too.txt
+
+# Result cache: concurrent runs share one directory and leave no temporary files behind
+for i in 1 2 3 4; do "$WER" --cache cache reference.txt hypothesis.txt > /dev/null 2>&1 & done
+wait
+expect "cache entry is complete" 0 "WER) is: 16.67 %" "$WER" --cache cache reference.txt hypothesis.txt
+expect "cache leaves one entry" 0 "" sh -c 'test "$(ls cache | wc -l)" -eq 1'
+
+echo "$((count - failures)) of $count tests passed"
+[ "$failures" -eq 0 ]
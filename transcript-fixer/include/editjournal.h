@@ -0,0 +1,55 @@
+#ifndef EDITJOURNAL_H
+#define EDITJOURNAL_H
+
+#include "include/utils.h"
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+// Append-only binary log of the edits made to a transcription. It starts with a snapshot of the
+// loaded file and every edit adds a small length-prefixed, checksummed record, flushed right away,
+// so a crash loses at most the edit being written. Once enough records pile up the log is
+// compacted into a new snapshot. Every transcription has its own journal, named after a hash of its
+// path, and one left behind by a crashed session is replayed when that file is opened again.
+class EditJournal
+{
+public:
+    explicit EditJournal(const QString &directory = default_directory());
+    ~EditJournal();
+
+    static QString default_directory();
+
+    QString path_for(const QString &sourcePath) const;
+    bool exists(const QString &sourcePath) const;
+    bool is_active() const { return file.isOpen(); }
+    void start(const QString &sourcePath, const QVector<TranscriptionElement*> &elements);
+    void compact(const QVector<TranscriptionElement*> &elements);
+    bool needs_compaction() const;
+    void record_change(int row, int column, const QString &value);
+    void record_insert(int row, const TranscriptionElement &element);
+    void record_remove(int row);
+    void record_replace(int row, int count, const QVector<TranscriptionElement> &elements);
+    bool replay(const QString &sourcePath, QVector<TranscriptionElement> &elements) const;
+    void discard();
+
+private:
+    enum RecordType : quint8
+    {
+        Snapshot,
+        Change,
+        Insert,
+        Remove,
+        Replace
+    };
+
+    QString directory;
+    QString path;
+    QFile file;
+    QString sourcePath;
+    qint64 snapshotSize = 0;
+    int recordsSinceSnapshot = 0;
+
+    void append(const QByteArray &payload);
+};
+
+#endif // EDITJOURNAL_H
@@ -0,0 +1,26 @@
+#ifndef ENERGYENVELOPE_H
+#define ENERGYENVELOPE_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// Short-time features of the decoded audio, per frame of params::ENERGY_FRAME_MS: the energy
+// (mean square of the samples) and the zero-crossing rate (sign changes per sample). Built once
+// per media file in a single vectorized pass, so looking for a pause only scans the few frames
+// around a point and voice activity detection never touches the samples.
+class EnergyEnvelope
+{
+public:
+    void build(const QVector<double>& samples, int sampleRate);
+    void clear();
+    bool is_empty() const { return energy.isEmpty(); }
+    qint64 quietest_point(qint64 fromMs, qint64 toMs, qint64 targetMs) const;
+    const QVector<float>& energies() const { return energy; }
+    const QVector<float>& crossing_rates() const { return crossingRate; }
+
+private:
+    QVector<float> energy;
+    QVector<float> crossingRate;
+};
+
+#endif // ENERGYENVELOPE_H
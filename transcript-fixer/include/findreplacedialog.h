@@ -0,0 +1,27 @@
+#ifndef FINDREPLACEDIALOG_H
+#define FINDREPLACEDIALOG_H
+
+#include <QDialog>
+#include <QLineEdit>
+#include <QCheckBox>
+
+// Modeless dialog collecting a find/replace request over the whole transcription
+class FindReplaceDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    explicit FindReplaceDialog(QWidget *parent = nullptr);
+    void set_find_text(const QString &text);
+
+signals:
+    void replace_all_requested(const QString &pattern, const QString &replacement, bool isRegex, Qt::CaseSensitivity caseSensitivity);
+
+private:
+    QLineEdit *findEdit;
+    QLineEdit *replaceEdit;
+    QCheckBox *regexCheckBox;
+    QCheckBox *caseCheckBox;
+};
+
+#endif // FINDREPLACEDIALOG_H
@@ -4,10 +4,13 @@
 #include "include/mediacontrol.h"
 #include "include/transcriptionmanager.h"
 #include "include/waveform.h"
+#include "include/findreplacedialog.h"
 #include <QMainWindow>
 #include <QTableWidgetItem>
 #include <QCloseEvent>
 #include <QLabel>
+#include <QLineEdit>
+#include <QPersistentModelIndex>
 
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -31,6 +34,14 @@ private:
     QVector<QAction*> helpActions;
     TranscriptionManager *transcriptionManager;
     Waveform *waveform;
+    QPersistentModelIndex activeRow;   // column 0 of the row highlighted during playback
+    QLineEdit *searchEdit;
+    FindReplaceDialog *findReplaceDialog;
+    QVector<int> searchMatches;
+    qsizetype searchMatchIndex;
+    qint64 syncTranscriptTime;
+    qint64 syncMediaTime;
+    QLabel *lintLabel;
 
     void initialize_ui();
     void initialize_toolbar();
@@ -42,6 +53,12 @@ private:
     void set_transcription_interface_enabled(bool enabled);
     void set_menu_actions();
     void set_menu_connections();
+    void set_row_highlighted(int row, bool highlighted);
+    int active_row() const;
+    void clear_active_row();
+    void show_invalid_time();
+    bool recover_unsaved_edits(const QString &filePath);
+    void show_search_match(qsizetype index);
     void update_label(QLabel* label, const QString& text, const QString& defaultText);
     QAction* find_action_by_text(const QVector<QAction*>& actions, const QString text);
 
@@ -52,6 +69,8 @@ private slots:
     void update_media_volume(int value);
     void update_audio_slider_position(qint64 position);
     void update_audio_slider_duration(qint64 duration);
+    void update_active_row(qint64 position);
+    void reset_active_row();
     void handle_media_status_changed(QMediaPlayer::MediaStatus status);
     void jump_to_time(QTableWidgetItem *item);
     void backward_button_clicked();
@@ -59,6 +78,17 @@ private slots:
     void add_row();
     void delete_row();
     void adjust_transcription_lines();
+    void search_transcription(const QString &query);
+    void next_search_match();
+    void show_find_replace();
+    void shift_timestamps();
+    void scale_timestamps();
+    void add_sync_point();
+    void next_lint_issue();
+    void snap_to_speech();
+    void skip_silence(qint64 position);
+    void update_lint_label(qsizetype rowsWithIssues);
+    void replace_all(const QString &pattern, const QString &replacement, bool isRegex, Qt::CaseSensitivity caseSensitivity);
 
     // Actions slots
     void open_media_file();
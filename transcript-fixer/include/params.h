@@ -13,9 +13,29 @@ namespace params {
                                                             std::make_pair(QStringLiteral("1.0x"), 1.0f),
                                                             std::make_pair(QStringLiteral("1.5x"), 1.5f),
                                                             std::make_pair(QStringLiteral("2.0x"), 2.0f) };
-    inline const QStringList FILE_TYPES = {QStringLiteral("Transcription"), QStringLiteral("Subtitle")};
+    inline const QStringList FILE_TYPES = {QStringLiteral("Transcription"), QStringLiteral("Subtitle"), QStringLiteral("WebVTT")};
     constexpr int DEFAULT_VOLUME = 50;
     constexpr int MAX_CHAR_PER_LINE = 80;
+    constexpr qint64 READ_CHUNK_SIZE = 64 * 1024;
+    constexpr qint64 FORMAT_DETECTION_SIZE = 512;
+    constexpr qsizetype CUE_OVERHEAD_BYTES = 64;
+    constexpr int JOURNAL_MIN_RECORDS = 1000;
+    constexpr int UNDO_LIMIT = 500;
+    constexpr qsizetype REPLACE_CHUNK_ROWS = 2048;
+    constexpr qint64 LINT_MAX_GAP_MS = 10000;
+    constexpr double LINT_MAX_CHARS_PER_SECOND = 20.0;
+    constexpr qsizetype LINT_CHUNK_ROWS = 4096;
+    constexpr int ENERGY_FRAME_MS = 10;
+    constexpr qint64 SPLIT_SEARCH_WINDOW_MS = 400;
+    constexpr int VAD_NOISE_PERCENTILE = 10;
+    constexpr float VAD_MIN_ENERGY = 1e-7f;
+    constexpr float VAD_SPEECH_RATIO = 8.0f;
+    constexpr float VAD_FRICATIVE_RATIO = 2.0f;
+    constexpr float VAD_FRICATIVE_CROSSING_RATE = 0.3f;
+    constexpr qint64 VAD_MIN_SILENCE_MS = 300;
+    constexpr qint64 VAD_MIN_SPEECH_MS = 100;
+    constexpr qint64 VAD_SNAP_DISTANCE_MS = 300;
+    constexpr qint64 VAD_SKIP_MIN_MS = 500;
 
     inline const QString MEDIA_FILE_UNOPEN_MESSAGE = QStringLiteral("Media file not opened.");
     inline const QString TRANSCRIPTION_FILE_UNOPEN_MESSAGE = QStringLiteral("Transcription file not opened.");
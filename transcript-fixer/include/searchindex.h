@@ -0,0 +1,27 @@
+#ifndef SEARCHINDEX_H
+#define SEARCHINDEX_H
+
+#include "include/utils.h"
+#include <QMap>
+#include <QStringList>
+#include <QVector>
+
+// Inverted index from lowercase words to the rows that contain them. Text edits update a single
+// row in place; structural changes (rows added, removed or split) call for a rebuild.
+class SearchIndex
+{
+public:
+    void rebuild(const QVector<TranscriptionElement*>& elements);
+    void update_row(int row, const QString &text);
+    QVector<int> find(const QString &query) const;
+    static QStringList tokenize(const QString &text);
+
+private:
+    QMap<QString, QVector<int>> postings;   // word -> sorted rows, sorted keys allow prefix lookups
+    QVector<QStringList> rowWords;          // distinct words of each row, to undo its postings
+
+    void add_row_words(int row);
+    void remove_row_words(int row);
+};
+
+#endif // SEARCHINDEX_H
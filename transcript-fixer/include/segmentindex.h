@@ -0,0 +1,27 @@
+#ifndef SEGMENTINDEX_H
+#define SEGMENTINDEX_H
+
+#include "include/utils.h"
+#include <QVector>
+
+struct SegmentSpan {
+    qint64 startMs;
+    qint64 endMs;
+    int row;
+};
+
+// Transcript segments sorted by start time, answering time queries with binary searches
+class SegmentIndex
+{
+public:
+    void rebuild(const QVector<TranscriptionElement*>& elements);
+    QVector<SegmentSpan> query(qint64 fromMs, qint64 toMs) const;
+    int row_at(qint64 timeMs) const;
+    qsizetype size() const { return spans.size(); };
+
+private:
+    QVector<SegmentSpan> spans;     // sorted by start time
+    QVector<qint64> maxEndPrefix;   // maxEndPrefix[i] is the latest end among spans[0..i]
+};
+
+#endif // SEGMENTINDEX_H
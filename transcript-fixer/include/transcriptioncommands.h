@@ -0,0 +1,108 @@
+#ifndef TRANSCRIPTIONCOMMANDS_H
+#define TRANSCRIPTIONCOMMANDS_H
+
+#include "include/utils.h"
+#include <QUndoCommand>
+#include <QVector>
+
+class TranscriptionManager;
+
+// One element replaced by the parts it was split into; row is its index before any split of the batch
+struct ElementSplit {
+    int row;
+    TranscriptionElement original;
+    QVector<TranscriptionElement> parts;
+};
+
+// New text of one element, with the text it replaces
+struct TextChange {
+    int row;
+    QString oldText;
+    QString newText;
+};
+
+// Undo commands keep only what they change, never a copy of the whole transcription
+
+class ChangeElementCommand : public QUndoCommand
+{
+public:
+    ChangeElementCommand(TranscriptionManager *manager, int row, int column, const QString &oldValue, const QString &newValue);
+    void undo() override;
+    void redo() override;
+    int id() const override { return 1; }
+    bool mergeWith(const QUndoCommand *other) override;
+
+private:
+    TranscriptionManager *manager;
+    int row;
+    int column;
+    QString oldValue;
+    QString newValue;
+};
+
+class InsertElementCommand : public QUndoCommand
+{
+public:
+    InsertElementCommand(TranscriptionManager *manager, int row, const TranscriptionElement &element);
+    void undo() override;
+    void redo() override;
+
+private:
+    TranscriptionManager *manager;
+    int row;
+    TranscriptionElement element;
+};
+
+class RemoveElementCommand : public QUndoCommand
+{
+public:
+    RemoveElementCommand(TranscriptionManager *manager, int row, const TranscriptionElement &element);
+    void undo() override;
+    void redo() override;
+
+private:
+    TranscriptionManager *manager;
+    int row;
+    TranscriptionElement element;
+};
+
+class SplitElementsCommand : public QUndoCommand
+{
+public:
+    SplitElementsCommand(TranscriptionManager *manager, const QVector<ElementSplit> &splits);
+    void undo() override;
+    void redo() override;
+
+private:
+    TranscriptionManager *manager;
+    QVector<ElementSplit> splits;
+};
+
+class ReplaceTextCommand : public QUndoCommand
+{
+public:
+    ReplaceTextCommand(TranscriptionManager *manager, const QVector<TextChange> &changes);
+    void undo() override;
+    void redo() override;
+
+private:
+    TranscriptionManager *manager;
+    QVector<TextChange> changes;
+};
+
+// Keeps the start and end strings of every element before and after; the strings are implicitly
+// shared with the elements, so the old side costs no copies of the text
+class RetimeCommand : public QUndoCommand
+{
+public:
+    RetimeCommand(TranscriptionManager *manager, const QVector<QString> &oldTimes, const QVector<QString> &newTimes);
+    void undo() override;
+    void redo() override;
+
+private:
+    TranscriptionManager *manager;
+    QVector<QString> oldTimes;
+    QVector<QString> newTimes;
+};
+
+#endif // TRANSCRIPTIONCOMMANDS_H
@@ -2,7 +2,17 @@
 #define TRANSCRIPTIONMANAGER_H
 
 #include "include/utils.h"
+#include "include/segmentindex.h"
+#include "include/searchindex.h"
+#include "include/transcriptlinter.h"
+#include "include/energyenvelope.h"
+#include "include/voiceactivity.h"
+#include "include/editjournal.h"
+#include "include/transcriptioncommands.h"
+#include "subtitle.h"
 #include <QObject>
+#include <QFutureWatcher>
+#include <QUndoStack>
 #include <QTableWidget>
 #include <QString>
 
@@ -16,16 +26,73 @@ public:
     void load_transcription(const QString &filePath);
     void save_transcription_as_txt(const QString &filePath);
     void save_transcription_as_srt(const QString &filePath);
+    void save_transcription_as_vtt(const QString &filePath);
     void change_transcription_element(int row, int column);
     void insert_transcription_element(int position);
     void remove_transcription_element(int position);
-    void split_transcription_element(int row, int maxLength);
+    int split_long_elements(int maxLength, const EnergyEnvelope* envelope = nullptr);
+    int first_invalid_time() const;
+    bool retime_elements(double scale, qint64 offsetMs);
+    bool sync_timestamps(qint64 transcriptA, qint64 mediaA, qint64 transcriptB, qint64 mediaB);
+    int snap_to_speech(const VoiceActivity& activity);
+    int replace_text(const QString &pattern, const QString &replacement, bool isRegex, Qt::CaseSensitivity caseSensitivity);
     void update_table();
     qsizetype element_count();
+    const SegmentIndex& segment_index();
+    QVector<int> search(const QString &query);
+    int next_lint_issue(int row) const;
+    qsizetype lint_issue_count() const { return linter.rows_with_issues(); }
+    QUndoStack* undo_stack() { return &undoStack; }
+    void begin_transaction();
+    void commit_transaction();
+    bool has_journal(const QString &filePath) const;
+    bool recover_from_journal(const QString &filePath);
+    void discard_journal();
+
+    // Primitives behind the undo commands: each updates the data, the table and the journal
+    void set_element_field(int row, int column, const QString &value);
+    void insert_element(int row, const TranscriptionElement &element);
+    void remove_element(int row);
+    void split_elements(const QVector<ElementSplit> &splits);
+    void join_elements(const QVector<ElementSplit> &splits);
+    void apply_text_changes(const QVector<TextChange> &changes, bool undo);
+    void set_times(const QVector<QString> &times);
+
+signals:
+    void transcription_changed();
+    void transcription_saved(const QString &filePath);
+    void transcription_save_failed(const QString &filePath, const QString &error);
+    void lint_changed(qsizetype rowsWithIssues);
+
+private slots:
+    void handle_save_finished();
 
 private:
     QTableWidget *tableWidget;
     QVector<TranscriptionElement *> transcriptionData;
+    SegmentIndex segmentIndex;
+    bool segmentIndexDirty = true;
+    SearchIndex searchIndex;
+    bool searchIndexDirty = true;
+    TranscriptLinter linter;
+    int transactionDepth = 0;
+    bool changedInTransaction = false;
+    bool tableSignalsBlocked = false;
+    QFutureWatcher<QString> saveWatcher;
+    QString savingPath;
+    QString pendingSavePath;
+    subtitle::Format pendingSaveFormat = subtitle::Format::Unknown;
+
+    EditJournal journal;
+    QUndoStack undoStack;
+
+    void mark_changed();
+    QString* element_field(int row, int column);
+    void set_table_row(int row, const TranscriptionElement &element);
+    void replace_rows(int row, int count, const QVector<TranscriptionElement> &elements);
+    void compact_journal_if_needed();
+    void decorate_lint_rows(const QVector<int> &rows);
+    void save_transcription(const QString &filePath, subtitle::Format format);
 
     void populate_table();
 };
@@ -0,0 +1,45 @@
+#ifndef TRANSCRIPTLINTER_H
+#define TRANSCRIPTLINTER_H
+
+#include "include/utils.h"
+#include <QString>
+#include <QVector>
+
+// Problems a row can have, combined as flags
+enum LintIssue : quint8 {
+    NoIssue = 0,
+    Overlap = 1 << 0,           // starts before the previous row ends
+    NegativeDuration = 1 << 1,  // ends before it starts
+    LongGap = 1 << 2,           // starts long after the previous row ends
+    ReadingSpeed = 1 << 3,      // more characters per second than can be read
+    LineLength = 1 << 4         // longer than params::MAX_CHAR_PER_LINE
+};
+
+// QA checks over the rows in table order. Every check of a row only looks at the row itself
+// and the one before it, so a full pass splits into independent parallel chunks and an edit
+// only needs the edited rows and their successor checked again. The update functions return the
+// rows whose table decoration has to be refreshed.
+class TranscriptLinter
+{
+public:
+    QVector<int> rebuild(const QVector<TranscriptionElement*>& elements);
+    QVector<int> update_row(int row, const TranscriptionElement &element);
+    QVector<int> replace_rows(int row, int count, const QVector<TranscriptionElement> &elements);
+    void clear();
+    quint8 issues(int row) const { return row >= 0 && row < flags.size() ? flags[row] : NoIssue; }
+    qsizetype rows_with_issues() const { return issueRows; }
+    static QString describe(quint8 issues);
+
+private:
+    QVector<qint64> starts;
+    QVector<qint64> ends;
+    QVector<int> lengths;
+    QVector<quint8> flags;
+    qsizetype issueRows = 0;
+
+    quint8 check_row(qsizetype row) const;
+    void set_row_data(qsizetype row, const TranscriptionElement &element);
+    QVector<int> recheck(qsizetype first, qsizetype last);
+};
+
+#endif // TRANSCRIPTLINTER_H
@@ -8,6 +8,8 @@
 #include <QRegularExpression>
 #include <QInputDialog>
 
+class EnergyEnvelope;
+
 struct TranscriptionElement {
     QString startTime;
     QString endTime;
@@ -17,11 +19,13 @@ struct TranscriptionElement {
 namespace utils {
     QString format_time(const qint64 ms);
     qint64 convert_time_to_ms(const QString &timeString);
+    bool parse_time_ms(const QString &timeString, qint64 &ms);
+    QString format_timestamp(qint64 ms);
     qint64 extract_start_time(const QString &text);
     qint64 extract_end_time(const QString &text);
     TranscriptionElement* extract_transcription_data(const QString &line);
     QStringList split_text_into_lines(const QString& text, int maxLength);
-    std::vector<std::pair<QString, QString>>* adjust_timestamp(const QString& startTime, const QString& endTime, int totalLines);
+    std::vector<std::pair<QString, QString>>* adjust_timestamp(const QString& startTime, const QString& endTime, const QStringList& lines, const EnergyEnvelope* envelope = nullptr);
     QString select_file_type();
     bool check_transcription_format(const QString& filePath);
 }
@@ -0,0 +1,31 @@
+#ifndef VOICEACTIVITY_H
+#define VOICEACTIVITY_H
+
+#include "include/energyenvelope.h"
+#include "include/segmentindex.h"
+#include <QVector>
+
+struct SpeechInterval {
+    qint64 startMs;
+    qint64 endMs;
+};
+
+// Speech/silence segmentation of the media from the frame features of its EnergyEnvelope. A frame
+// is speech when its energy is well above the noise floor of the file, or somewhat above it with
+// the high zero-crossing rate of a fricative; short pauses inside speech and short bursts inside
+// silence are smoothed away. The intervals are sorted and do not overlap.
+class VoiceActivity
+{
+public:
+    void detect(const EnergyEnvelope& envelope);
+    void clear() { intervals.clear(); }
+    const QVector<SpeechInterval>& speech() const { return intervals; }
+    qint64 next_speech(qint64 timeMs) const;
+    qint64 snap_to_boundary(qint64 timeMs, bool start, qint64 maxDistanceMs) const;
+    QVector<SpeechInterval> untranscribed(const SegmentIndex& segments) const;
+
+private:
+    QVector<SpeechInterval> intervals;
+};
+
+#endif // VOICEACTIVITY_H
@@ -3,8 +3,14 @@
 
 #include "qcustomplot.h"
 #include "mediacontrol.h"
+#include "segmentindex.h"
+#include "energyenvelope.h"
+#include "voiceactivity.h"
 #include <QAudioFormat>
 #include <QAudioDecoder>
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QWindow>
 
 class Waveform : public QCustomPlot
 {
@@ -13,23 +19,77 @@ public:
     explicit Waveform(MediaControl* mediaControl, QWidget *parent = nullptr);
     ~Waveform();
     void set_source(const QString& fileName);
+    void set_segments(const SegmentIndex& index);
+    const EnergyEnvelope& energy_envelope() const { return envelope; }
+    const VoiceActivity& voice_activity() const { return voiceActivity; }
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
 
 public slots:
     void set_buffer();
     void update_waveform(qint64 currentTimeMs);
 
+private slots:
+    void build_peaks();
+    void sync_position(qint64 positionMs);
+    void handle_playback_state_changed(QMediaPlayer::PlaybackState state);
+    void handle_view_range_changed(const QCPRange& newRange);
+    void handle_mouse_press(QMouseEvent* event);
+    void render_frame();
+
 private:
-    qreal get_peak_value(const QAudioFormat& format);
-    void initialize_timer();
+    // Min/max envelope of the samples at one zoom level
+    struct PeakLevel {
+        int bucketSize;
+        QVector<float> minima;
+        QVector<float> maxima;
+    };
+
+    void move_marker(qint64 currentTimeMs);
+    bool is_in_page(int sampleIndex) const;
+    void redraw_view();
+    int choose_level() const;
+    int bucket_size(int level) const;
+    void append_units(int level, int from, int to);
+    void set_marker(int sampleIndex);
+    void draw_segments();
+    void draw_untranscribed_speech(qint64 fromMs, qint64 toMs);
+    QCPItemRect* reuse_item(QVector<QCPItemRect*>& items, qsizetype index);
+    void draw_overview();
+    void request_frame();
     void configure_waveform_appearance();
+    void configure_overview();
     QAudioDecoder *decoder;
     QAudioBuffer buffer;
     QVector<double> samples;
+    QVector<PeakLevel> peakLevels;
+    EnergyEnvelope envelope;
+    VoiceActivity voiceActivity;
+    QVector<SpeechInterval> untranscribedSpeech;
     QCPGraph *wavePlot;
     QCPItemLine *marker;
+    QCPAxisRect *overviewRect;
+    QCPGraph *overviewPlot;
+    QCPItemRect *overviewWindow;
+    QCPItemLine *overviewMarker;
+    SegmentIndex segments;
+    QVector<QCPItemRect*> segmentItems; // reused between redraws, hidden when unused
+    QVector<QCPItemRect*> speechItems;  // same for the untranscribed speech marks
     qint64 durationMs;
     int sampleRate;
-    QTimer* updateTimer;
+    int plottedLevel;   // peak level held by wavePlot, -1 for raw samples
+    int plottedStart;   // first bucket (or sample) currently held by wavePlot
+    int plottedEnd;     // one past the last bucket (or sample) held by wavePlot
+    int viewStart;      // first sample index of the visible page, -1 if nothing is shown
+    int viewWidth;      // number of samples visible in the detail view
+    bool followPlayhead;
+    bool updatingView;
+    bool playing;
+    QPointer<QWindow> frameWindow;  // the window whose frame updates drive the marker
+    qint64 lastReportedPosition;
+    QElapsedTimer positionClock;
+    qreal playbackRate;
     MediaControl* mediaControl;
 signals:
 };
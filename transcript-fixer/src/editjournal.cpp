@@ -0,0 +1,304 @@
+#include "include/editjournal.h"
+#include "include/params.h"
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+static constexpr quint32 JOURNAL_MAGIC = 0x54464a31;   // "TFJ1"
+
+// The path a journal is keyed by, the same however the file was named when it was opened
+static QString journal_key(const QString &sourcePath)
+{
+    return QFileInfo(sourcePath).absoluteFilePath();
+}
+
+static void write_element(QDataStream &stream, const TranscriptionElement &element)
+{
+    stream << element.startTime << element.endTime << element.text;
+}
+
+static TranscriptionElement read_element(QDataStream &stream)
+{
+    TranscriptionElement element;
+    stream >> element.startTime >> element.endTime >> element.text;
+    return element;
+}
+
+static QVector<TranscriptionElement> read_elements(QDataStream &stream)
+{
+    quint32 count = 0;
+    stream >> count;
+    QVector<TranscriptionElement> elements;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        elements.push_back(read_element(stream));
+    }
+    return elements;
+}
+
+EditJournal::EditJournal(const QString &directory)
+    : directory(directory)
+{
+}
+
+EditJournal::~EditJournal()
+{
+    // The file stays on disk: only a clean exit discards it
+    file.close();
+}
+
+QString EditJournal::default_directory()
+{
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/journals");
+    QDir().mkpath(directory);
+    return directory;
+}
+
+QString EditJournal::path_for(const QString &sourcePath) const
+{
+    QByteArray hash = QCryptographicHash::hash(journal_key(sourcePath).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return directory + QLatin1Char('/') + QString::fromLatin1(hash.left(16)) + QStringLiteral(".journal");
+}
+
+// Whether another session left a journal for sourcePath. The snapshot at its start must name the
+// same file, so a hash collision or a foreign file is never offered for recovery.
+bool EditJournal::exists(const QString &sourcePath) const
+{
+    QString journalPath = path_for(sourcePath);
+    if (is_active() && journalPath == path)
+    {
+        return false;
+    }
+    QFile in(journalPath);
+    if (!in.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream stream(&in);
+    quint32 magic = 0;
+    quint32 length = 0;
+    quint16 checksum = 0;
+    quint8 type = 0;
+    QString storedPath;
+    stream >> magic >> length >> checksum >> type >> storedPath;
+    return stream.status() == QDataStream::Ok && magic == JOURNAL_MAGIC && type == Snapshot &&
+           storedPath == journal_key(sourcePath);
+}
+
+// Switches to the journal of sourcePath. The journal of the transcription open before is
+// discarded, its edits were either saved or abandoned by opening another file.
+void EditJournal::start(const QString &sourcePath, const QVector<TranscriptionElement*> &elements)
+{
+    QString journalPath = path_for(sourcePath);
+    if (journalPath != path)
+    {
+        discard();
+        path = journalPath;
+        file.setFileName(path);
+    }
+    this->sourcePath = journal_key(sourcePath);
+    compact(elements);
+}
+
+// Rewrites the journal as a single snapshot; QSaveFile keeps the old journal until the new one is complete
+void EditJournal::compact(const QVector<TranscriptionElement*> &elements)
+{
+    file.close();
+
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record << static_cast<quint8>(Snapshot) << sourcePath << static_cast<quint32>(elements.size());
+    for (const TranscriptionElement* element : elements)
+    {
+        write_element(record, *element);
+    }
+
+    QSaveFile snapshot(path);
+    if (!snapshot.open(QIODevice::WriteOnly))
+    {
+        qWarning() << "Cannot write the edit journal" << path << snapshot.errorString();
+        return;
+    }
+    QDataStream stream(&snapshot);
+    stream << JOURNAL_MAGIC << static_cast<quint32>(payload.size()) << qChecksum(payload);
+    stream.writeRawData(payload.constData(), payload.size());
+    if (!snapshot.commit())
+    {
+        qWarning() << "Cannot write the edit journal" << path << snapshot.errorString();
+        return;
+    }
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append))
+    {
+        snapshotSize = file.size();
+        recordsSinceSnapshot = 0;
+    }
+}
+
+// Compacting costs about one snapshot, so waiting until the records outweigh it keeps the I/O
+// proportional to the size of the edits
+bool EditJournal::needs_compaction() const
+{
+    return is_active() && recordsSinceSnapshot >= params::JOURNAL_MIN_RECORDS &&
+           file.size() > 2 * snapshotSize;
+}
+
+void EditJournal::record_change(int row, int column, const QString &value)
+{
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record << static_cast<quint8>(Change) << static_cast<qint32>(row) << static_cast<qint32>(column) << value;
+    append(payload);
+}
+
+void EditJournal::record_insert(int row, const TranscriptionElement &element)
+{
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record << static_cast<quint8>(Insert) << static_cast<qint32>(row);
+    write_element(record, element);
+    append(payload);
+}
+
+void EditJournal::record_remove(int row)
+{
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record << static_cast<quint8>(Remove) << static_cast<qint32>(row);
+    append(payload);
+}
+
+// Replaces count rows starting at row with the given elements (a split, or the undo of one)
+void EditJournal::record_replace(int row, int count, const QVector<TranscriptionElement> &elements)
+{
+    QByteArray payload;
+    QDataStream record(&payload, QIODevice::WriteOnly);
+    record << static_cast<quint8>(Replace) << static_cast<qint32>(row) << static_cast<qint32>(count)
+           << static_cast<quint32>(elements.size());
+    for (const TranscriptionElement &element : elements)
+    {
+        write_element(record, element);
+    }
+    append(payload);
+}
+
+void EditJournal::append(const QByteArray &payload)
+{
+    if (!is_active())
+    {
+        return;
+    }
+    QDataStream stream(&file);
+    stream << static_cast<quint32>(payload.size()) << qChecksum(payload);
+    stream.writeRawData(payload.constData(), payload.size());
+    file.flush();
+    ++recordsSinceSnapshot;
+}
+
+// Rebuilds the transcription of sourcePath from the last snapshot and the records after it. A record
+// cut short by a crash fails its length or checksum test and ends the replay.
+bool EditJournal::replay(const QString &sourcePath, QVector<TranscriptionElement> &elements) const
+{
+    QFile in(path_for(sourcePath));
+    if (!in.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QDataStream stream(&in);
+    quint32 magic = 0;
+    stream >> magic;
+    if (magic != JOURNAL_MAGIC)
+    {
+        return false;
+    }
+
+    bool hasSnapshot = false;
+    QString storedPath;
+    while (!stream.atEnd())
+    {
+        quint32 length = 0;
+        quint16 checksum = 0;
+        stream >> length >> checksum;
+        if (stream.status() != QDataStream::Ok || length > static_cast<quint64>(in.bytesAvailable()))
+        {
+            break;
+        }
+        QByteArray payload(length, Qt::Uninitialized);
+        if (stream.readRawData(payload.data(), length) != static_cast<int>(length) || qChecksum(payload) != checksum)
+        {
+            break;
+        }
+
+        QDataStream record(payload);
+        quint8 type = 0;
+        qint32 row = 0;
+        record >> type;
+        if (type == Snapshot)
+        {
+            record >> storedPath;
+            elements = read_elements(record);
+            hasSnapshot = true;
+            continue;
+        }
+        record >> row;
+        switch (type)
+        {
+        case Change:
+        {
+            qint32 column = 0;
+            QString value;
+            record >> column >> value;
+            if (row >= 0 && row < elements.size())
+            {
+                QString* fields[] = {&elements[row].startTime, &elements[row].endTime, &elements[row].text};
+                if (column >= 0 && column < 3)
+                {
+                    *fields[column] = value;
+                }
+            }
+            break;
+        }
+        case Insert:
+            elements.insert(qBound(0, static_cast<int>(row), static_cast<int>(elements.size())), read_element(record));
+            break;
+        case Remove:
+            if (row >= 0 && row < elements.size())
+            {
+                elements.removeAt(row);
+            }
+            break;
+        case Replace:
+        {
+            qint32 count = 0;
+            record >> count;
+            if (row >= 0 && count >= 0 && row + count <= elements.size())
+            {
+                elements.remove(row, count);
+                QVector<TranscriptionElement> replacement = read_elements(record);
+                for (qsizetype i = 0; i < replacement.size(); ++i)
+                {
+                    elements.insert(row + i, replacement[i]);
+                }
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return hasSnapshot && storedPath == journal_key(sourcePath);
+}
+
+void EditJournal::discard()
+{
+    file.close();
+    if (!path.isEmpty())
+    {
+        QFile::remove(path);
+    }
+    recordsSinceSnapshot = 0;
+}
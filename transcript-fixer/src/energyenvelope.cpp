@@ -0,0 +1,100 @@
+#include "include/energyenvelope.h"
+#include "include/params.h"
+#include <cstdlib>
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ENERGYENVELOPE_SSE2
+#endif
+
+// Sum of squares and number of sign changes between consecutive samples of one frame. An hour
+// of audio is a few hundred million samples, so the SSE2 path works on four at a time with two
+// accumulators; the scalar loop finishes the frame and is the whole kernel elsewhere.
+static void frame_features(const double* data, qsizetype count, double& sumSquares, qsizetype& crossings)
+{
+    sumSquares = 0;
+    crossings = 0;
+    qsizetype i = 0;
+#ifdef ENERGYENVELOPE_SSE2
+    const __m128d zero = _mm_setzero_pd();
+    __m128d sumLow = _mm_setzero_pd();
+    __m128d sumHigh = _mm_setzero_pd();
+    for (; i + 4 < count; i += 4)
+    {
+        __m128d low = _mm_loadu_pd(data + i);
+        __m128d high = _mm_loadu_pd(data + i + 2);
+        sumLow = _mm_add_pd(sumLow, _mm_mul_pd(low, low));
+        sumHigh = _mm_add_pd(sumHigh, _mm_mul_pd(high, high));
+        // A sample and its successor have opposite signs when their product is negative
+        __m128d productLow = _mm_mul_pd(low, _mm_loadu_pd(data + i + 1));
+        __m128d productHigh = _mm_mul_pd(high, _mm_loadu_pd(data + i + 3));
+        int mask = _mm_movemask_pd(_mm_cmplt_pd(productLow, zero)) | (_mm_movemask_pd(_mm_cmplt_pd(productHigh, zero)) << 2);
+        crossings += (mask & 1) + ((mask >> 1) & 1) + ((mask >> 2) & 1) + (mask >> 3);
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sumLow, sumHigh));
+    sumSquares = lanes[0] + lanes[1];
+#endif
+    for (; i < count; ++i)
+    {
+        sumSquares += data[i] * data[i];
+        if (i + 1 < count && data[i] * data[i + 1] < 0)
+        {
+            ++crossings;
+        }
+    }
+}
+
+void EnergyEnvelope::build(const QVector<double>& samples, int sampleRate)
+{
+    clear();
+    qsizetype frameSize = static_cast<qsizetype>(sampleRate) * params::ENERGY_FRAME_MS / 1000;
+    if (frameSize <= 0)
+    {
+        return;
+    }
+
+    qsizetype frameCount = (samples.size() + frameSize - 1) / frameSize;
+    energy.resize(frameCount);
+    crossingRate.resize(frameCount);
+    const double* data = samples.constData();
+    for (qsizetype frame = 0; frame < frameCount; ++frame)
+    {
+        qsizetype from = frame * frameSize;
+        qsizetype count = qMin(frameSize, samples.size() - from);
+        double sumSquares;
+        qsizetype crossings;
+        frame_features(data + from, count, sumSquares, crossings);
+        energy[frame] = sumSquares / count;
+        crossingRate[frame] = static_cast<float>(crossings) / count;
+    }
+}
+
+void EnergyEnvelope::clear()
+{
+    energy.clear();
+    crossingRate.clear();
+}
+
+// Middle of the lowest-energy frame between fromMs and toMs, the one closest to targetMs among
+// equally quiet frames. Returns targetMs when the range is outside the decoded audio.
+qint64 EnergyEnvelope::quietest_point(qint64 fromMs, qint64 toMs, qint64 targetMs) const
+{
+    qsizetype first = qMax<qint64>(fromMs / params::ENERGY_FRAME_MS, 0);
+    qsizetype last = qMin<qint64>(toMs / params::ENERGY_FRAME_MS, energy.size() - 1);
+    if (first > last)
+    {
+        return targetMs;
+    }
+
+    qsizetype targetFrame = targetMs / params::ENERGY_FRAME_MS;
+    qsizetype best = first;
+    for (qsizetype frame = first + 1; frame <= last; ++frame)
+    {
+        if (energy[frame] < energy[best] ||
+            (energy[frame] == energy[best] && std::abs(frame - targetFrame) < std::abs(best - targetFrame)))
+        {
+            best = frame;
+        }
+    }
+    return qBound(fromMs, static_cast<qint64>(best) * params::ENERGY_FRAME_MS + params::ENERGY_FRAME_MS / 2, toMs);
+}
@@ -0,0 +1,35 @@
+#include "include/findreplacedialog.h"
+#include <QDialogButtonBox>
+#include <QFormLayout>
+#include <QPushButton>
+
+FindReplaceDialog::FindReplaceDialog(QWidget *parent)
+    : QDialog(parent), findEdit(new QLineEdit(this)), replaceEdit(new QLineEdit(this)),
+      regexCheckBox(new QCheckBox(tr("Regular expression"), this)), caseCheckBox(new QCheckBox(tr("Match case"), this))
+{
+    setWindowTitle(tr("Find and Replace"));
+
+    QFormLayout *layout = new QFormLayout(this);
+    layout->addRow(tr("Find:"), findEdit);
+    layout->addRow(tr("Replace with:"), replaceEdit);
+    layout->addRow(regexCheckBox);
+    layout->addRow(caseCheckBox);
+
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Close, this);
+    QPushButton *replaceAllButton = buttons->addButton(tr("Replace All"), QDialogButtonBox::ActionRole);
+    replaceAllButton->setDefault(true);
+    layout->addRow(buttons);
+
+    connect(buttons, &QDialogButtonBox::rejected, this, &QDialog::reject);
+    connect(replaceAllButton, &QPushButton::clicked, this, [this]() {
+        emit replace_all_requested(findEdit->text(), replaceEdit->text(), regexCheckBox->isChecked(),
+                                   caseCheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive);
+    });
+}
+
+void FindReplaceDialog::set_find_text(const QString &text)
+{
+    findEdit->setText(text);
+    findEdit->selectAll();
+    findEdit->setFocus();
+}
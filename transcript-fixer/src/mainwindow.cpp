@@ -8,7 +8,9 @@
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent), ui(new Ui::MainWindow),
-    mediaControl(new MediaControl)
+    mediaControl(new MediaControl), searchEdit(new QLineEdit(this)),
+    findReplaceDialog(new FindReplaceDialog(this)), searchMatchIndex(-1), syncTranscriptTime(-1), syncMediaTime(0),
+    lintLabel(new QLabel(this))
 
 {
     ui->setupUi(this);
@@ -49,6 +51,7 @@ void MainWindow::initialize_ui()
     ui->statusbar->showMessage("Welcome to TranscriptFixer! Use Ctrl+O to open a media file, or Ctrl+L to open a transcription file", 10000);
 
     ui->verticalLayout_4->addWidget(waveform);
+    ui->statusbar->addPermanentWidget(lintLabel);
 
     set_default_icons();
 
@@ -69,6 +72,11 @@ void MainWindow::initialize_toolbar()
     ui->toolbar->addSeparator();
     ui->toolbar->addAction(editActions.at(0));
     ui->toolbar->addAction(editActions.at(1));
+    ui->toolbar->addSeparator();
+    searchEdit->setPlaceholderText(tr("Search (Ctrl+F)"));
+    searchEdit->setClearButtonEnabled(true);
+    searchEdit->setMaximumWidth(250);
+    ui->toolbar->addWidget(searchEdit);
     ui->toolbar->setIconSize(QSize(16, 16));
 }
 
@@ -79,6 +87,8 @@ void MainWindow::connect_signals()
     connect(ui->speedComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::change_playback_rate);
     connect(ui->volumeSlider, &QSlider::valueChanged, this, &MainWindow::update_media_volume);
     connect(mediaControl->get_media_player(), &QMediaPlayer::positionChanged, this, &MainWindow::update_audio_slider_position);
+    connect(mediaControl->get_media_player(), &QMediaPlayer::positionChanged, this, &MainWindow::update_active_row);
+    connect(mediaControl->get_media_player(), &QMediaPlayer::positionChanged, this, &MainWindow::skip_silence);
     connect(mediaControl->get_media_player(), &QMediaPlayer::durationChanged, this, &MainWindow::update_audio_slider_duration);
     connect(ui->audioSlider, &QSlider::sliderMoved, mediaControl->get_media_player(),&QMediaPlayer::setPosition);
     connect(mediaControl->get_media_player(), &QMediaPlayer::mediaStatusChanged, this, &MainWindow::handle_media_status_changed);
@@ -92,6 +102,24 @@ void MainWindow::connect_signals()
     connect(ui->tableWidget, &QTableWidget::cellChanged, this, [this](int row, int column) {
         transcriptionManager->change_transcription_element(row, column);
     });
+    connect(transcriptionManager, &TranscriptionManager::transcription_changed, this, [this]() {
+        waveform->set_segments(transcriptionManager->segment_index());
+    });
+    connect(transcriptionManager, &TranscriptionManager::transcription_changed, this, &MainWindow::reset_active_row);
+    connect(transcriptionManager, &TranscriptionManager::transcription_changed, this, [this]() {
+        searchMatches.clear();  // rows may have moved, the next Enter searches again
+    });
+    connect(searchEdit, &QLineEdit::textChanged, this, &MainWindow::search_transcription);
+    connect(searchEdit, &QLineEdit::returnPressed, this, &MainWindow::next_search_match);
+    connect(transcriptionManager, &TranscriptionManager::lint_changed, this, &MainWindow::update_lint_label);
+    connect(findReplaceDialog, &FindReplaceDialog::replace_all_requested, this, &MainWindow::replace_all);
+    connect(transcriptionManager, &TranscriptionManager::transcription_saved, this, [this](const QString &filePath) {
+        ui->statusbar->showMessage("File saved: " + QFileInfo(filePath).fileName(), 5000);
+    });
+    connect(transcriptionManager, &TranscriptionManager::transcription_save_failed, this, [this](const QString &filePath, const QString &error) {
+        ui->statusbar->showMessage("Error: File could not be saved", 5000);
+        QMessageBox::warning(this, "Error", "Failed to save " + filePath + ":\n" + error);
+    });
 }
 
 void MainWindow::set_default_icons()
@@ -148,6 +176,7 @@ void MainWindow::set_transcription_interface_enabled(bool enabled)
     ui->adjustLongLinesButton->setEnabled(enabled);
     ui->saveButton->setEnabled(enabled);
     ui->tableWidget->setEnabled(enabled);
+    searchEdit->setEnabled(enabled);
     QAction* saveAction = find_action_by_text(fileActions, "&Save Transcription");
     if (saveAction != nullptr)
     {
@@ -178,6 +207,26 @@ void MainWindow::set_menu_actions()
     // Edit Actions
     editActions.push_back(new QAction(QIcon(":/icons/row_management/add"), tr("Add row"), this));
     editActions.push_back(new QAction(QIcon(":/icons/row_management/remove"), tr("Delete row"), this));
+    editActions.push_back(new QAction(tr("Follow playback"), this));
+    editActions.last()->setCheckable(true);
+    editActions.last()->setChecked(true);
+    editActions.push_back(new QAction(tr("&Find"), this));
+    editActions.last()->setShortcut(QKeySequence::Find);
+    editActions.push_back(new QAction(tr("Find and &Replace"), this));
+    editActions.last()->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_H));
+    editActions.push_back(new QAction(tr("Shift timestamps..."), this));
+    editActions.push_back(new QAction(tr("Scale timestamps..."), this));
+    editActions.push_back(new QAction(tr("Add sync point"), this));
+    editActions.last()->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_K));
+    editActions.push_back(new QAction(tr("Next issue"), this));
+    editActions.last()->setShortcut(QKeySequence(Qt::Key_F8));
+    editActions.push_back(new QAction(tr("Snap to speech"), this));
+    editActions.push_back(new QAction(tr("Skip silences"), this));
+    editActions.last()->setCheckable(true);
+    editActions.push_back(transcriptionManager->undo_stack()->createUndoAction(this, tr("&Undo")));
+    editActions.last()->setShortcut(QKeySequence::Undo);
+    editActions.push_back(transcriptionManager->undo_stack()->createRedoAction(this, tr("&Redo")));
+    editActions.last()->setShortcut(QKeySequence::Redo);
     for (QAction* action : editActions)
     {
         ui->menuEdit->addAction(action);
@@ -207,6 +256,16 @@ void MainWindow::set_menu_connections()
     // Edit connections
     connect(editActions.at(0), &QAction::triggered, this, &MainWindow::add_row);
     connect(editActions.at(1), &QAction::triggered, this, &MainWindow::delete_row);
+    connect(find_action_by_text(editActions, tr("&Find")), &QAction::triggered, this, [this]() {
+        searchEdit->setFocus();
+        searchEdit->selectAll();
+    });
+    connect(find_action_by_text(editActions, tr("Find and &Replace")), &QAction::triggered, this, &MainWindow::show_find_replace);
+    connect(find_action_by_text(editActions, tr("Shift timestamps...")), &QAction::triggered, this, &MainWindow::shift_timestamps);
+    connect(find_action_by_text(editActions, tr("Scale timestamps...")), &QAction::triggered, this, &MainWindow::scale_timestamps);
+    connect(find_action_by_text(editActions, tr("Add sync point")), &QAction::triggered, this, &MainWindow::add_sync_point);
+    connect(find_action_by_text(editActions, tr("Next issue")), &QAction::triggered, this, &MainWindow::next_lint_issue);
+    connect(find_action_by_text(editActions, tr("Snap to speech")), &QAction::triggered, this, &MainWindow::snap_to_speech);
 
     // Help connections
     connect(helpActions.at(0), &QAction::triggered, this, &MainWindow::show_shortcuts);
@@ -214,6 +273,20 @@ void MainWindow::set_menu_connections()
     connect(helpActions.at(2), &QAction::triggered, this, &MainWindow::show_about);
 }
 
+void MainWindow::set_row_highlighted(int row, bool highlighted)
+{
+    // Background changes are reported through cellChanged too, keep them away from the manager
+    QSignalBlocker blocker(ui->tableWidget);
+    for (int column = 0; column < ui->tableWidget->columnCount(); ++column)
+    {
+        QTableWidgetItem* item = ui->tableWidget->item(row, column);
+        if (item)
+        {
+            item->setData(Qt::BackgroundRole, highlighted ? QVariant(QColor(255, 230, 140)) : QVariant());
+        }
+    }
+}
+
 void MainWindow::update_label(QLabel* label, const QString& fileName, const QString& defaultText)
 {
     if (fileName.isEmpty())
@@ -285,6 +358,57 @@ void MainWindow::update_audio_slider_duration(qint64 duration)
     ui->totalDurationLabel->setText(utils::format_time(duration));
 }
 
+void MainWindow::update_active_row(qint64 position)
+{
+    QAction* followAction = find_action_by_text(editActions, tr("Follow playback"));
+    if (followAction == nullptr || !followAction->isChecked())
+    {
+        return;
+    }
+
+    int row = transcriptionManager->segment_index().row_at(position);
+    if (row == active_row() || row >= ui->tableWidget->rowCount())
+    {
+        return;
+    }
+
+    clear_active_row();
+    if (row >= 0)
+    {
+        activeRow = QPersistentModelIndex(ui->tableWidget->model()->index(row, 0));
+        set_row_highlighted(row, true);
+        // Do not pull the table away from a cell the user is typing in
+        if (ui->tableWidget->state() != QAbstractItemView::EditingState)
+        {
+            ui->tableWidget->scrollToItem(ui->tableWidget->item(row, 0), QAbstractItemView::PositionAtCenter);
+        }
+    }
+}
+
+// The highlighted row, followed through rows inserted or removed above it, or -1
+int MainWindow::active_row() const
+{
+    return activeRow.isValid() ? activeRow.row() : -1;
+}
+
+// Removes the highlight from wherever the highlighted row has moved; nothing if it was removed
+void MainWindow::clear_active_row()
+{
+    int row = active_row();
+    if (row >= 0)
+    {
+        set_row_highlighted(row, false);
+    }
+    activeRow = QPersistentModelIndex();
+}
+
+void MainWindow::reset_active_row()
+{
+    // Rows may have moved: drop the old highlight and find the segment again
+    clear_active_row();
+    update_active_row(mediaControl->get_position());
+}
+
 void MainWindow::handle_media_status_changed(QMediaPlayer::MediaStatus status)
 {
     if (status == QMediaPlayer::EndOfMedia)
@@ -320,12 +444,6 @@ void MainWindow::forward_button_clicked()
 
 void MainWindow::add_row()
 {
-    const QString defaultTimestamp = "00:00:00,000";
-    const QString defaultText = "";
-
-    // Block signals ssafely with QSignalBlocker
-    QSignalBlocker blocker(ui->tableWidget);
-
     if (!ui->tableWidget)
         return;
 
@@ -335,18 +453,7 @@ void MainWindow::add_row()
         currentRow = ui->tableWidget->rowCount();
     }
 
-    // Insert a new row at the specified position
-    ui->tableWidget->insertRow(currentRow);
-
-    // Create items with default values and set alignment
-    QTableWidgetItem *startItem = new QTableWidgetItem(defaultTimestamp);
-    QTableWidgetItem *endItem = new QTableWidgetItem(defaultTimestamp);
-    QTableWidgetItem *textItem = new QTableWidgetItem(defaultText);
-    ui->tableWidget->setItem(currentRow, 0, startItem);
-    ui->tableWidget->setItem(currentRow, 1, endItem);
-    ui->tableWidget->setItem(currentRow, 2, textItem);
-
-    // Update the transcription manager
+    // The transcription manager inserts the row in the table too, as an undoable step
     transcriptionManager->insert_transcription_element(currentRow);
     ui->statusbar->showMessage("Row created", 2000);
 }
@@ -356,9 +463,6 @@ void MainWindow::delete_row()
     if (!ui->tableWidget || ui->tableWidget->rowCount() == 0)
         return;
 
-    // Block signals to prevent unwanted changes
-    QSignalBlocker blocker(ui->tableWidget);
-
     int currentRow = ui->tableWidget->currentRow();
     if (currentRow == -1)
     {
@@ -366,7 +470,6 @@ void MainWindow::delete_row()
     }
     if (currentRow >= 0)
     {
-        ui->tableWidget->removeRow(currentRow);
         transcriptionManager->remove_transcription_element(currentRow);
         ui->statusbar->showMessage("Row deleted", 2000);
     }
@@ -374,14 +477,210 @@ void MainWindow::delete_row()
 
 void MainWindow::adjust_transcription_lines()
 {
-    long long int i = 0;
-    while (i < transcriptionManager->element_count())
+    int splitCount = transcriptionManager->split_long_elements(params::MAX_CHAR_PER_LINE, &waveform->energy_envelope());
+    ui->statusbar->showMessage(QString("Transcription lines adjusted (%1 split)").arg(splitCount), 2000);
+}
+
+void MainWindow::search_transcription(const QString &query)
+{
+    searchMatches = transcriptionManager->search(query);
+    searchMatchIndex = -1;
+    if (query.trimmed().isEmpty())
     {
-        transcriptionManager->split_transcription_element(i, params::MAX_CHAR_PER_LINE);
-        ++i;
+        ui->statusbar->clearMessage();
     }
-    transcriptionManager->update_table();
-    ui->statusbar->showMessage("Transcription lines adjusted", 2000);
+    else if (searchMatches.isEmpty())
+    {
+        ui->statusbar->showMessage("No matches", 2000);
+    }
+    else
+    {
+        show_search_match(0);
+    }
+}
+
+void MainWindow::next_search_match()
+{
+    if (searchMatches.isEmpty())
+    {
+        search_transcription(searchEdit->text());
+        return;
+    }
+    show_search_match((searchMatchIndex + 1) % searchMatches.size());
+}
+
+void MainWindow::show_search_match(qsizetype index)
+{
+    searchMatchIndex = index;
+    int row = searchMatches.at(index);
+    QTableWidgetItem* item = ui->tableWidget->item(row, 2);
+    if (item == nullptr)
+    {
+        return;
+    }
+    ui->tableWidget->setCurrentItem(item);
+    ui->tableWidget->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+    jump_to_time(item);
+    ui->statusbar->showMessage(QString("Match %1 of %2").arg(index + 1).arg(searchMatches.size()), 5000);
+}
+
+void MainWindow::show_find_replace()
+{
+    findReplaceDialog->set_find_text(searchEdit->text());
+    findReplaceDialog->show();
+    findReplaceDialog->raise();
+    findReplaceDialog->activateWindow();
+}
+
+void MainWindow::replace_all(const QString &pattern, const QString &replacement, bool isRegex, Qt::CaseSensitivity caseSensitivity)
+{
+    int changedRows = transcriptionManager->replace_text(pattern, replacement, isRegex, caseSensitivity);
+    if (changedRows < 0)
+    {
+        QMessageBox::warning(findReplaceDialog, "Error", "The regular expression is not valid.");
+        return;
+    }
+    ui->statusbar->showMessage(QString("Replaced in %1 rows").arg(changedRows), 5000);
+}
+
+void MainWindow::shift_timestamps()
+{
+    bool ok;
+    double seconds = QInputDialog::getDouble(this, "Shift Timestamps", "Seconds to add to every timestamp (negative to move earlier):",
+                                             0.0, -86400.0, 86400.0, 3, &ok);
+    if (ok && seconds != 0.0)
+    {
+        if (transcriptionManager->retime_elements(1.0, qRound64(seconds * 1000)))
+        {
+            ui->statusbar->showMessage("Timestamps shifted", 2000);
+        }
+        else
+        {
+            show_invalid_time();
+        }
+    }
+}
+
+void MainWindow::scale_timestamps()
+{
+    bool ok;
+    double factor = QInputDialog::getDouble(this, "Scale Timestamps", "Factor to multiply every timestamp by (e.g. 25/23.976 = 1.042708):",
+                                            1.0, 0.001, 1000.0, 6, &ok);
+    if (ok && factor != 1.0)
+    {
+        if (transcriptionManager->retime_elements(factor, 0))
+        {
+            ui->statusbar->showMessage("Timestamps scaled", 2000);
+        }
+        else
+        {
+            show_invalid_time();
+        }
+    }
+}
+
+// Two-point sync: for two rows, play the media to where the row is actually spoken and add a
+// sync point; the second point shifts and stretches every timestamp to match both
+void MainWindow::add_sync_point()
+{
+    int row = ui->tableWidget->currentRow();
+    if (row < 0 || ui->tableWidget->item(row, 0) == nullptr)
+    {
+        ui->statusbar->showMessage("Warning: Select the row to sync first", 5000);
+        return;
+    }
+    qint64 transcriptTime = 0;
+    if (!utils::parse_time_ms(ui->tableWidget->item(row, 0)->text(), transcriptTime))
+    {
+        ui->statusbar->showMessage("Warning: The start time of the selected row is not valid", 5000);
+        return;
+    }
+    qint64 mediaTime = mediaControl->get_position();
+
+    if (syncTranscriptTime < 0)
+    {
+        syncTranscriptTime = transcriptTime;
+        syncMediaTime = mediaTime;
+        ui->statusbar->showMessage("Sync point 1 set, now sync a second row far from the first", 5000);
+        return;
+    }
+
+    if (transcriptionManager->first_invalid_time() >= 0)
+    {
+        // The sync points stay set, the sync can be repeated once the time is fixed
+        show_invalid_time();
+        return;
+    }
+    bool synced = transcriptionManager->sync_timestamps(syncTranscriptTime, syncMediaTime, transcriptTime, mediaTime);
+    syncTranscriptTime = -1;
+    ui->statusbar->showMessage(synced ? "Timestamps synced to the media" : "Warning: The sync points do not define a valid timing", 5000);
+}
+
+// Selects the first row with a time that does not parse, a retime would turn it into 00:00:00
+void MainWindow::show_invalid_time()
+{
+    int row = transcriptionManager->first_invalid_time();
+    if (row < 0)
+    {
+        return;
+    }
+    QTableWidgetItem* item = ui->tableWidget->item(row, 0);
+    if (item != nullptr)
+    {
+        ui->tableWidget->setCurrentItem(item);
+        ui->tableWidget->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+    }
+    ui->statusbar->showMessage(QString("Warning: Line %1 has an invalid time, nothing was changed").arg(row + 1), 5000);
+}
+
+// Moves to the next row flagged by the linter, the tooltip of its cells says what is wrong
+void MainWindow::next_lint_issue()
+{
+    int row = transcriptionManager->next_lint_issue(ui->tableWidget->currentRow());
+    if (row < 0)
+    {
+        ui->statusbar->showMessage("No issues found", 2000);
+        return;
+    }
+    QTableWidgetItem* item = ui->tableWidget->item(row, 0);
+    if (item == nullptr)
+    {
+        return;
+    }
+    ui->tableWidget->setCurrentItem(item);
+    ui->tableWidget->scrollToItem(item, QAbstractItemView::PositionAtCenter);
+    ui->statusbar->showMessage(item->toolTip().replace('\n', "; "), 5000);
+}
+
+void MainWindow::snap_to_speech()
+{
+    if (waveform->voice_activity().speech().isEmpty())
+    {
+        ui->statusbar->showMessage("Warning: No speech detected, open the media file first", 5000);
+        return;
+    }
+    int moved = transcriptionManager->snap_to_speech(waveform->voice_activity());
+    ui->statusbar->showMessage(QString("%1 timestamps snapped to speech").arg(moved), 5000);
+}
+
+// With Edit > Skip silences checked, playback jumps over pauses longer than params::VAD_SKIP_MIN_MS
+void MainWindow::skip_silence(qint64 position)
+{
+    QAction* skipAction = find_action_by_text(editActions, tr("Skip silences"));
+    if (skipAction == nullptr || !skipAction->isChecked() || mediaControl->get_state() != MediaControl::PlaybackState::Playing)
+    {
+        return;
+    }
+    qint64 next = waveform->voice_activity().next_speech(position);
+    if (next - position > params::VAD_SKIP_MIN_MS)
+    {
+        mediaControl->set_position(next);
+    }
+}
+
+void MainWindow::update_lint_label(qsizetype rowsWithIssues)
+{
+    lintLabel->setText(rowsWithIssues > 0 ? QString("%1 rows with issues").arg(rowsWithIssues) : QString());
 }
 
 void MainWindow::open_media_file()
@@ -417,16 +716,25 @@ void MainWindow::load_transcription_file()
     QString filePath = QFileDialog::getOpenFileName(this,
                                                     "Open Transcription File",
                                                     QDir::homePath(),
-                                                    "Text Files (*.txt);;All Files (*.*)");
+                                                    "Transcription Files (*.txt *.srt *.vtt);;All Files (*.*)");
     if (!filePath.isEmpty())
     {
         if (utils::check_transcription_format(filePath))
         {
-            transcriptionManager->load_transcription(filePath);
             QFileInfo fileInfo(filePath);
-            update_label(ui->transcriptionFilenameLabel, fileInfo.fileName(), "");
+            if (recover_unsaved_edits(filePath))
+            {
+                update_label(ui->transcriptionFilenameLabel, fileInfo.fileName() + " (recovered)", "");
+                ui->statusbar->showMessage("Unsaved edits recovered", 5000);
+            }
+            else
+            {
+                // Loading starts a new journal for the file, replacing the one left behind
+                transcriptionManager->load_transcription(filePath);
+                update_label(ui->transcriptionFilenameLabel, fileInfo.fileName(), "");
+                ui->statusbar->showMessage("Transcription file loaded", 5000);
+            }
             set_transcription_interface_enabled(true);
-            ui->statusbar->showMessage("Transcription file loaded", 5000);
         }
         else
         {
@@ -445,7 +753,7 @@ void MainWindow::save_transcription()
 
     if (!fileType.isEmpty())
     {
-        QString filter = QStringLiteral("All (*.*);;Text files (*.txt);;Subtitle files (*.srt)");
+        QString filter = QStringLiteral("All (*.*);;Text files (*.txt);;Subtitle files (*.srt);;WebVTT files (*.vtt)");
         QString filePath = QFileDialog::getSaveFileName(this,
                                                         "Save File",
                                                         QDir::homePath(), filter);
@@ -458,12 +766,17 @@ void MainWindow::save_transcription()
             if(fileType == params::FILE_TYPES.at(0))    // Transcription type
             {
                 transcriptionManager->save_transcription_as_txt(filePath);
-                ui->statusbar->showMessage("File saved as text transcription", 5000);
+                ui->statusbar->showMessage("Saving text transcription...");
             }
             else if(fileType == params::FILE_TYPES.at(1))   // Subtitle type
             {
                 transcriptionManager->save_transcription_as_srt(filePath);
-                ui->statusbar->showMessage("File saved as subtitle", 5000);
+                ui->statusbar->showMessage("Saving subtitle...");
+            }
+            else if(fileType == params::FILE_TYPES.at(2))   // WebVTT type
+            {
+                transcriptionManager->save_transcription_as_vtt(filePath);
+                ui->statusbar->showMessage("Saving WebVTT...");
             }
             else
             {
@@ -495,6 +808,14 @@ void MainWindow::show_shortcuts()
     shortcutsText += "<b>Jump to Time:</b> Double-click on transcription<br>";
     shortcutsText += "<b>Add row:</b> Ctrl++<br>";
     shortcutsText += "<b>Delete row:</b> Ctrl+-<br>";
+    shortcutsText += "<b>Undo/Redo:</b> Ctrl+Z / Ctrl+Shift+Z<br>";
+    shortcutsText += "<b>Search:</b> Ctrl+F, Enter for the next match<br>";
+    shortcutsText += "<b>Find and replace:</b> Ctrl+H<br>";
+    shortcutsText += "<b>Add sync point (selected row = media position):</b> Ctrl+K<br>";
+    shortcutsText += "<b>Next row with issues:</b> F8<br>";
+    shortcutsText += "<b>Zoom waveform:</b> Mouse wheel<br>";
+    shortcutsText += "<b>Pan waveform:</b> Drag (double-click to follow playback again)<br>";
+    shortcutsText += "<b>Seek from overview:</b> Click on the lower waveform strip<br>";
     shortcutsText += "<b>Quit:</b> Ctrl+Q";
 
     QMessageBox::information(this, "Shortcuts", shortcutsText);
@@ -528,6 +849,29 @@ void MainWindow::show_about()
     QMessageBox::information(this, tr("About TranscriptFixer"), aboutText);
 }
 
+// Offers the edits that a session which did not close properly left for filePath, returns true
+// if they were restored instead of loading the file
+bool MainWindow::recover_unsaved_edits(const QString &filePath)
+{
+    if (!transcriptionManager->has_journal(filePath))
+    {
+        return false;
+    }
+    QMessageBox::StandardButton reply;
+    reply = QMessageBox::question(this, "Recover Edits", "A previous session editing this file did not close properly. Do you want to recover its unsaved edits?",
+                                  QMessageBox::Yes | QMessageBox::No);
+    if (reply != QMessageBox::Yes)
+    {
+        return false;
+    }
+    if (!transcriptionManager->recover_from_journal(filePath))
+    {
+        ui->statusbar->showMessage("Warning: The unsaved edits could not be recovered", 5000);
+        return false;
+    }
+    return true;
+}
+
 void MainWindow::closeEvent(QCloseEvent *event)
 {
     QMessageBox::StandardButton reply;
@@ -535,6 +879,8 @@ void MainWindow::closeEvent(QCloseEvent *event)
                                   QMessageBox::Yes | QMessageBox::No);
     if (reply == QMessageBox::Yes)
     {
+        // A clean exit leaves no journal behind to recover
+        transcriptionManager->discard_journal();
         event->accept();
     }
     else
@@ -0,0 +1,130 @@
+#include "include/searchindex.h"
+#include <algorithm>
+
+QStringList SearchIndex::tokenize(const QString &text)
+{
+    QStringList words;
+    QString word;
+    for (QChar c : text)
+    {
+        if (c.isLetterOrNumber())
+        {
+            word += c.toLower();
+        }
+        else if (!word.isEmpty())
+        {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.isEmpty())
+    {
+        words.push_back(word);
+    }
+    return words;
+}
+
+void SearchIndex::rebuild(const QVector<TranscriptionElement*>& elements)
+{
+    postings.clear();
+    rowWords.clear();
+    rowWords.resize(elements.size());
+    // Rows are visited in order, so every posting list is built already sorted
+    for (qsizetype row = 0; row < elements.size(); ++row)
+    {
+        rowWords[row] = tokenize(elements[row]->text);
+        rowWords[row].removeDuplicates();
+        add_row_words(row);
+    }
+}
+
+void SearchIndex::update_row(int row, const QString &text)
+{
+    if (row < 0 || row >= rowWords.size())
+    {
+        return;
+    }
+    remove_row_words(row);
+    rowWords[row] = tokenize(text);
+    rowWords[row].removeDuplicates();
+    add_row_words(row);
+}
+
+void SearchIndex::add_row_words(int row)
+{
+    for (const QString &word : rowWords[row])
+    {
+        QVector<int> &rows = postings[word];
+        rows.insert(std::lower_bound(rows.begin(), rows.end(), row), row);
+    }
+}
+
+void SearchIndex::remove_row_words(int row)
+{
+    for (const QString &word : rowWords[row])
+    {
+        auto posting = postings.find(word);
+        if (posting == postings.end())
+        {
+            continue;
+        }
+        QVector<int> &rows = posting.value();
+        auto it = std::lower_bound(rows.begin(), rows.end(), row);
+        if (it != rows.end() && *it == row)
+        {
+            rows.erase(it);
+        }
+        if (rows.isEmpty())
+        {
+            postings.erase(posting);
+        }
+    }
+}
+
+// Rows containing every word of the query, the last one matched as a prefix so that results
+// follow the typing. Each row counts the query words it has seen, which keeps the work linear
+// in the size of the posting lists involved.
+QVector<int> SearchIndex::find(const QString &query) const
+{
+    QStringList words = tokenize(query);
+    if (words.isEmpty())
+    {
+        return {};
+    }
+    QString prefix = words.takeLast();
+    words.removeDuplicates();
+
+    QVector<int> matched(rowWords.size(), 0);
+    int required = 0;
+    for (const QString &word : words)
+    {
+        auto posting = postings.constFind(word);
+        if (posting == postings.cend())
+        {
+            return {};
+        }
+        for (int row : posting.value())
+        {
+            if (matched[row] == required)
+            {
+                ++matched[row];
+            }
+        }
+        ++required;
+    }
+
+    QVector<int> rows;
+    for (auto posting = postings.lowerBound(prefix); posting != postings.cend() && posting.key().startsWith(prefix); ++posting)
+    {
+        for (int row : posting.value())
+        {
+            if (matched[row] == required)
+            {
+                ++matched[row];   // a row matching several completions is reported once
+                rows.push_back(row);
+            }
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+}
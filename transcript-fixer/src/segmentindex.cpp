@@ -0,0 +1,62 @@
+#include "include/segmentindex.h"
+#include <algorithm>
+#include <iterator>
+
+void SegmentIndex::rebuild(const QVector<TranscriptionElement*>& elements)
+{
+    spans.clear();
+    spans.reserve(elements.size());
+    for (qsizetype i = 0; i < elements.size(); ++i)
+    {
+        qint64 startMs = utils::convert_time_to_ms(elements[i]->startTime);
+        qint64 endMs = utils::convert_time_to_ms(elements[i]->endTime);
+        spans.push_back({startMs, qMax(startMs, endMs), static_cast<int>(i)});
+    }
+
+    // Rows are almost always in time order already, so this is usually a no-op pass
+    std::stable_sort(spans.begin(), spans.end(), [](const SegmentSpan& a, const SegmentSpan& b) {
+        return a.startMs < b.startMs;
+    });
+
+    maxEndPrefix.resize(spans.size());
+    qint64 maxEnd = 0;
+    for (qsizetype i = 0; i < spans.size(); ++i)
+    {
+        maxEnd = qMax(maxEnd, spans[i].endMs);
+        maxEndPrefix[i] = maxEnd;
+    }
+}
+
+QVector<SegmentSpan> SegmentIndex::query(qint64 fromMs, qint64 toMs) const
+{
+    // Candidates start before the window ends and come after the first span that reaches into it
+    auto last = std::lower_bound(spans.cbegin(), spans.cend(), toMs, [](const SegmentSpan& span, qint64 time) {
+        return span.startMs < time;
+    });
+    auto firstEnd = std::upper_bound(maxEndPrefix.cbegin(), maxEndPrefix.cend(), fromMs);
+    auto first = spans.cbegin() + (firstEnd - maxEndPrefix.cbegin());
+
+    QVector<SegmentSpan> result;
+    for (auto it = first; it < last; ++it)
+    {
+        if (it->endMs > fromMs)
+        {
+            result.push_back(*it);
+        }
+    }
+    return result;
+}
+
+int SegmentIndex::row_at(qint64 timeMs) const
+{
+    // Latest segment starting at or before timeMs, if it is still running
+    auto next = std::upper_bound(spans.cbegin(), spans.cend(), timeMs, [](qint64 time, const SegmentSpan& span) {
+        return time < span.startMs;
+    });
+    if (next == spans.cbegin())
+    {
+        return -1;
+    }
+    auto current = std::prev(next);
+    return timeMs < current->endMs ? current->row : -1;
+}
@@ -0,0 +1,110 @@
+#include "include/transcriptioncommands.h"
+#include "include/transcriptionmanager.h"
+
+ChangeElementCommand::ChangeElementCommand(TranscriptionManager *manager, int row, int column, const QString &oldValue, const QString &newValue)
+    : manager(manager), row(row), column(column), oldValue(oldValue), newValue(newValue)
+{
+    setText(QObject::tr("edit row %1").arg(row + 1));
+}
+
+void ChangeElementCommand::undo()
+{
+    manager->set_element_field(row, column, oldValue);
+}
+
+void ChangeElementCommand::redo()
+{
+    manager->set_element_field(row, column, newValue);
+}
+
+// Consecutive edits of the same cell undo as one
+bool ChangeElementCommand::mergeWith(const QUndoCommand *other)
+{
+    const ChangeElementCommand *change = static_cast<const ChangeElementCommand*>(other);
+    if (change->row != row || change->column != column)
+    {
+        return false;
+    }
+    newValue = change->newValue;
+    return true;
+}
+
+InsertElementCommand::InsertElementCommand(TranscriptionManager *manager, int row, const TranscriptionElement &element)
+    : manager(manager), row(row), element(element)
+{
+    setText(QObject::tr("add row %1").arg(row + 1));
+}
+
+void InsertElementCommand::undo()
+{
+    manager->remove_element(row);
+}
+
+void InsertElementCommand::redo()
+{
+    manager->insert_element(row, element);
+}
+
+RemoveElementCommand::RemoveElementCommand(TranscriptionManager *manager, int row, const TranscriptionElement &element)
+    : manager(manager), row(row), element(element)
+{
+    setText(QObject::tr("delete row %1").arg(row + 1));
+}
+
+void RemoveElementCommand::undo()
+{
+    manager->insert_element(row, element);
+}
+
+void RemoveElementCommand::redo()
+{
+    manager->remove_element(row);
+}
+
+SplitElementsCommand::SplitElementsCommand(TranscriptionManager *manager, const QVector<ElementSplit> &splits)
+    : manager(manager), splits(splits)
+{
+    setText(QObject::tr("split %n line(s)", nullptr, splits.size()));
+}
+
+void SplitElementsCommand::undo()
+{
+    manager->join_elements(splits);
+}
+
+void SplitElementsCommand::redo()
+{
+    manager->split_elements(splits);
+}
+
+ReplaceTextCommand::ReplaceTextCommand(TranscriptionManager *manager, const QVector<TextChange> &changes)
+    : manager(manager), changes(changes)
+{
+    setText(QObject::tr("replace in %n row(s)", nullptr, changes.size()));
+}
+
+void ReplaceTextCommand::undo()
+{
+    manager->apply_text_changes(changes, true);
+}
+
+void ReplaceTextCommand::redo()
+{
+    manager->apply_text_changes(changes, false);
+}
+
+RetimeCommand::RetimeCommand(TranscriptionManager *manager, const QVector<QString> &oldTimes, const QVector<QString> &newTimes)
+    : manager(manager), oldTimes(oldTimes), newTimes(newTimes)
+{
+    setText(QObject::tr("change timestamps"));
+}
+
+void RetimeCommand::undo()
+{
+    manager->set_times(oldTimes);
+}
+
+void RetimeCommand::redo()
+{
+    manager->set_times(newTimes);
+}
@@ -1,16 +1,71 @@
 #include "include/transcriptionmanager.h"
+#include "include/params.h"
 #include <QFile>
-#include <QTextStream>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QRegularExpression>
+#include <QColor>
 #include <QMessageBox>
 #include <QDebug>
 
+// Formats a snapshot of the transcription and writes it atomically, runs on a worker thread.
+// Returns an error message, empty on success. Nothing is written if a time cannot be parsed.
+static QString write_snapshot(const QVector<TranscriptionElement> &snapshot, const QString &filePath, subtitle::Format format)
+{
+    std::size_t estimate = 0;
+    for (const TranscriptionElement &element : snapshot)
+    {
+        estimate += element.text.size() + params::CUE_OVERHEAD_BYTES;
+    }
+    std::string out;
+    out.reserve(estimate);
+
+    subtitle::write_header(out, format);
+    subtitle::Cue cue;
+    qint64 start = 0;
+    qint64 end = 0;
+    for (qsizetype i = 0; i < snapshot.size(); ++i)
+    {
+        // A time that does not parse would be written as 00:00:00,000, so refuse to save instead
+        if (!utils::parse_time_ms(snapshot[i].startTime, start))
+        {
+            return QObject::tr("Line %1 has an invalid start time \"%2\"").arg(i + 1).arg(snapshot[i].startTime);
+        }
+        if (!utils::parse_time_ms(snapshot[i].endTime, end))
+        {
+            return QObject::tr("Line %1 has an invalid end time \"%2\"").arg(i + 1).arg(snapshot[i].endTime);
+        }
+        cue.startMs = start;
+        cue.endMs = end;
+        cue.text = snapshot[i].text.toStdString();
+        subtitle::write_cue(out, format, cue, i + 1);
+    }
+
+    // QSaveFile writes to a temporary file and renames it on commit, a failed save leaves the old file intact
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return file.errorString();
+    }
+    if (file.write(out.data(), out.size()) != static_cast<qint64>(out.size()) || !file.commit())
+    {
+        return file.errorString();
+    }
+    return QString();
+}
+
 TranscriptionManager::TranscriptionManager(QObject *parent, QTableWidget *table)
     : QObject(parent), tableWidget(table)
 {
+    connect(&saveWatcher, &QFutureWatcher<QString>::finished, this, &TranscriptionManager::handle_save_finished);
+    undoStack.setUndoLimit(params::UNDO_LIMIT);
 }
 
 TranscriptionManager::~TranscriptionManager()
 {
+    // Let a running save reach the disk before quitting
+    saveWatcher.waitForFinished();
     for (TranscriptionElement* elem : transcriptionData)
     {
         delete elem;
@@ -21,154 +76,480 @@ TranscriptionManager::~TranscriptionManager()
 void TranscriptionManager::load_transcription(const QString &filePath)
 {
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    if (!file.open(QIODevice::ReadOnly))
     {
         QMessageBox::warning(nullptr, "Error", "Failed to open the file.");
             return;
     }
 
-    QTextStream in(&file);
-
     for (TranscriptionElement* elem : transcriptionData)
     {
         delete elem;
     }
     transcriptionData.clear();
 
-    while (!in.atEnd())
+    // The format (bracketed, SRT or WebVTT) is detected from the first lines and the file is
+    // parsed in chunks, so large subtitle files load without a conversion step
+    subtitle::Parser parser(subtitle::Format::Unknown, [this](const subtitle::Cue &cue)
     {
-        QString line = in.readLine();
-        if (!line.isEmpty())
-        {
-            transcriptionData.push_back(utils::extract_transcription_data(line));
-        }
+        TranscriptionElement* elem = new TranscriptionElement;
+        elem->startTime = QString::fromStdString(subtitle::format_timestamp(cue.startMs));
+        elem->endTime = QString::fromStdString(subtitle::format_timestamp(cue.endMs));
+        elem->text = QString::fromStdString(cue.text);
+        transcriptionData.push_back(elem);
+    });
+    QByteArray chunk(params::READ_CHUNK_SIZE, Qt::Uninitialized);
+    qint64 count;
+    while ((count = file.read(chunk.data(), chunk.size())) > 0)
+    {
+        parser.feed(std::string_view(chunk.constData(), count));
+    }
+    parser.finish();
+    if (parser.malformed_count() > 0)
+    {
+        qWarning() << "Skipped" << parser.malformed_count() << "malformed lines in" << filePath;
     }
 
     file.close();
     populate_table();
+    undoStack.clear();
+    journal.start(filePath, transcriptionData);
 }
 
 void TranscriptionManager::save_transcription_as_txt(const QString &filePath)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        QMessageBox::warning(nullptr, "Error", "Failed to save the file.");
-        return;
-    }
-
-    QTextStream out(&file);
-    for (const TranscriptionElement* element : transcriptionData)
-    {
-        out << "[" << element->startTime << " - " << element->endTime << "] " << element->text << "\n";
-    }
-    file.close();
+    save_transcription(filePath, subtitle::Format::Bracketed);
 }
 
 void TranscriptionManager::save_transcription_as_srt(const QString &filePath)
 {
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
-    {
-        QMessageBox::warning(nullptr, "Error", "Failed tosave the file.");
-        return;
-    }
-
-    QTextStream out(&file);
-    qsizetype counter = 1;
-    for (const TranscriptionElement* element : transcriptionData)
-    {
-        out << counter << "\n";
-        out << element->startTime << " --> " << element->endTime << "\n";
-        out << element->text << "\n\n";
-        ++counter;
-    }
+    save_transcription(filePath, subtitle::Format::Srt);
+}
 
-    file.close();
+void TranscriptionManager::save_transcription_as_vtt(const QString &filePath)
+{
+    save_transcription(filePath, subtitle::Format::WebVtt);
 }
 
+// Edits typed into the table arrive here through cellChanged and become undoable commands
 void TranscriptionManager::change_transcription_element(int row, int column)
 {
     // Ensure the row exists in the transcriptionData vector
     if (row >= 0 && row < transcriptionData.size())
     {
         QTableWidgetItem* item = tableWidget->item(row, column);
-        if (item)
+        QString* field = element_field(row, column);
+        // Leaving a cell without changing its text is not an edit
+        if (item && field != nullptr && *field != item->text())
         {
-            QString newValue = item->text();
-            switch (column)
-            {
-            case 0:
-                transcriptionData[row]->startTime = newValue;
-                break;
-            case 1:
-                transcriptionData[row]->endTime = newValue;
-                break;
-            case 2:
-                transcriptionData[row]->text = newValue;
-                break;
-            default:
-                break;
-            }
+            undoStack.push(new ChangeElementCommand(this, row, column, *field, item->text()));
         }
     }
 }
 
 void TranscriptionManager::insert_transcription_element(int row)
 {
-    TranscriptionElement* newElement = new TranscriptionElement;
-    newElement->startTime = QStringLiteral("00:00:00,000");
-    newElement->endTime = QStringLiteral("00:00:00,000");
-    newElement->text = QStringLiteral("");
+    TranscriptionElement newElement;
+    newElement.startTime = QStringLiteral("00:00:00,000");
+    newElement.endTime = QStringLiteral("00:00:00,000");
+    newElement.text = QStringLiteral("");
 
-    transcriptionData.insert(transcriptionData.cbegin() + row, newElement);
+    undoStack.push(new InsertElementCommand(this, row, newElement));
 }
 
 void TranscriptionManager::remove_transcription_element(int row)
 {
     if (row >= 0 && row < transcriptionData.size())
     {
-        TranscriptionElement *elem = transcriptionData[row];
-        delete elem;
-        transcriptionData.erase(transcriptionData.cbegin() + row);
+        undoStack.push(new RemoveElementCommand(this, row, *transcriptionData[row]));
     }
 }
 
-void TranscriptionManager::split_transcription_element(int row, int maxLength)
+// Splits every element longer than maxLength into lines, as one undo step. The timestamps are
+// divided by line length and, given the energy envelope of the media, moved to nearby pauses.
+int TranscriptionManager::split_long_elements(int maxLength, const EnergyEnvelope* envelope)
 {
-    if (row >= 0 && row < transcriptionData.size())
+    QVector<ElementSplit> splits;
+    for (qsizetype row = 0; row < transcriptionData.size(); ++row)
     {
-        TranscriptionElement* element = transcriptionData[row];
+        const TranscriptionElement* element = transcriptionData[row];
         QStringList splitText = utils::split_text_into_lines(element->text, maxLength);
 
         if (splitText.size() <= 1)
         {
-            return; // No need to split if there's nothing to split
+            continue; // No need to split if there's nothing to split
         }
 
-        QString originalStart = element->startTime;
-        QString originalEnd = element->endTime;
+        std::vector<std::pair<QString, QString>>* times = utils::adjust_timestamp(element->startTime, element->endTime, splitText, envelope);
 
-        std::vector<std::pair<QString, QString>>* times = utils::adjust_timestamp(originalStart, originalEnd, splitText.size());
+        ElementSplit split{static_cast<int>(row), *element, {}};
+        for (int i = 0; i < splitText.size(); ++i)
+        {
+            split.parts.push_back({times->at(i).first, times->at(i).second, splitText[i]});
+        }
+        delete times; // Clean up the times vector
+        splits.push_back(split);
+    }
 
-        // Clear the original element
-        delete element; // Clean up the original element
-        transcriptionData.erase(transcriptionData.begin() + row); // Remove the original element
+    if (!splits.isEmpty())
+    {
+        undoStack.push(new SplitElementsCommand(this, splits));
+    }
+    return splits.size();
+}
 
-        for (int i = 0; i < splitText.size(); ++i)
+// Replaces every occurrence of pattern in the text column, as one undo step. The rows are
+// scanned in parallel chunks over a snapshot of the texts; the changes are applied afterwards
+// in a single transaction. Returns the number of rows changed, or -1 for an invalid regex.
+int TranscriptionManager::replace_text(const QString &pattern, const QString &replacement, bool isRegex, Qt::CaseSensitivity caseSensitivity)
+{
+    if (pattern.isEmpty())
+    {
+        return 0;
+    }
+    QRegularExpression regex;
+    if (isRegex)
+    {
+        regex.setPattern(pattern);
+        if (caseSensitivity == Qt::CaseInsensitive)
+        {
+            regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+        }
+        if (!regex.isValid())
         {
-            TranscriptionElement* newElement = new TranscriptionElement;
-            newElement->text = splitText[i];
-            newElement->startTime = times->at(i).first;
-            newElement->endTime = times->at(i).second;
+            return -1;
+        }
+        regex.optimize();
+    }
+
+    QVector<QString> texts;
+    texts.reserve(transcriptionData.size());
+    for (const TranscriptionElement* element : transcriptionData)
+    {
+        texts.push_back(element->text);
+    }
 
-            // Insert the new element at the same index
-            transcriptionData.insert(transcriptionData.begin() + row + i, newElement);
+    QList<qsizetype> chunkStarts;
+    for (qsizetype first = 0; first < texts.size(); first += params::REPLACE_CHUNK_ROWS)
+    {
+        chunkStarts.push_back(first);
+    }
+    QList<QVector<TextChange>> chunkChanges = QtConcurrent::blockingMapped(chunkStarts, [&](qsizetype first)
+    {
+        QVector<TextChange> changes;
+        qsizetype last = qMin(first + params::REPLACE_CHUNK_ROWS, texts.size());
+        for (qsizetype row = first; row < last; ++row)
+        {
+            QString text = texts[row];
+            if (isRegex)
+            {
+                text.replace(regex, replacement);
+            }
+            else
+            {
+                text.replace(pattern, replacement, caseSensitivity);
+            }
+            if (text != texts[row])
+            {
+                changes.push_back({static_cast<int>(row), texts[row], text});
+            }
+        }
+        return changes;
+    });
+
+    QVector<TextChange> changes;
+    for (const QVector<TextChange> &chunk : chunkChanges)
+    {
+        changes.append(chunk);
+    }
+    if (!changes.isEmpty())
+    {
+        undoStack.push(new ReplaceTextCommand(this, changes));
+    }
+    return changes.size();
+}
+
+void TranscriptionManager::apply_text_changes(const QVector<TextChange> &changes, bool undo)
+{
+    begin_transaction();
+    for (const TextChange &change : changes)
+    {
+        set_element_field(change.row, 2, undo ? change.oldText : change.newText);
+    }
+    commit_transaction();
+}
+
+// Returns the first row whose start or end time does not parse, or -1 if every time is valid
+int TranscriptionManager::first_invalid_time() const
+{
+    qint64 ms = 0;
+    for (qsizetype i = 0; i < transcriptionData.size(); ++i)
+    {
+        if (!utils::parse_time_ms(transcriptionData[i]->startTime, ms) || !utils::parse_time_ms(transcriptionData[i]->endTime, ms))
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Maps every timestamp t to t * scale + offsetMs, as one undo step. The times are parsed once
+// into a contiguous array and transformed by a single branch-free loop, then formatted back.
+// Nothing changes if a time does not parse, first_invalid_time() tells which row to fix.
+bool TranscriptionManager::retime_elements(double scale, qint64 offsetMs)
+{
+    qsizetype count = transcriptionData.size();
+    QVector<QString> oldTimes(2 * count);
+    QVector<qint64> times(2 * count);
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        oldTimes[2 * i] = transcriptionData[i]->startTime;
+        oldTimes[2 * i + 1] = transcriptionData[i]->endTime;
+        if (!utils::parse_time_ms(oldTimes[2 * i], times[2 * i]) || !utils::parse_time_ms(oldTimes[2 * i + 1], times[2 * i + 1]))
+        {
+            return false;
+        }
+    }
+
+    qint64* data = times.data();
+    for (qsizetype i = 0; i < times.size(); ++i)
+    {
+        data[i] = qMax<qint64>(0, static_cast<qint64>(data[i] * scale + 0.5) + offsetMs);
+    }
+
+    QVector<QString> newTimes(2 * count);
+    for (qsizetype i = 0; i < times.size(); ++i)
+    {
+        newTimes[i] = utils::format_timestamp(times[i]);
+    }
+    if (count > 0)
+    {
+        undoStack.push(new RetimeCommand(this, oldTimes, newTimes));
+    }
+    return true;
+}
+
+// Two-point sync: the linear map that takes transcript time A to media time A and B to B
+bool TranscriptionManager::sync_timestamps(qint64 transcriptA, qint64 mediaA, qint64 transcriptB, qint64 mediaB)
+{
+    if (transcriptA == transcriptB)
+    {
+        return false;
+    }
+    double scale = static_cast<double>(mediaB - mediaA) / (transcriptB - transcriptA);
+    if (scale <= 0)
+    {
+        return false;
+    }
+    return retime_elements(scale, qRound64(mediaA - transcriptA * scale));
+}
+
+// Moves every start to the nearest detected speech onset and every end to the nearest speech
+// offset, when one is close enough, as one undo step. Rows with a time that does not parse are
+// left alone. Returns the number of timestamps moved.
+int TranscriptionManager::snap_to_speech(const VoiceActivity& activity)
+{
+    qsizetype count = transcriptionData.size();
+    QVector<QString> oldTimes(2 * count);
+    QVector<QString> newTimes(2 * count);
+    int moved = 0;
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        oldTimes[2 * i] = newTimes[2 * i] = transcriptionData[i]->startTime;
+        oldTimes[2 * i + 1] = newTimes[2 * i + 1] = transcriptionData[i]->endTime;
+        qint64 startMs = 0;
+        qint64 endMs = 0;
+        if (!utils::parse_time_ms(oldTimes[2 * i], startMs) || !utils::parse_time_ms(oldTimes[2 * i + 1], endMs))
+        {
+            continue; // a time that does not parse is left for the user to fix
+        }
+        qint64 snappedStart = activity.snap_to_boundary(startMs, true, params::VAD_SNAP_DISTANCE_MS);
+        qint64 snappedEnd = activity.snap_to_boundary(endMs, false, params::VAD_SNAP_DISTANCE_MS);
+        if (snappedEnd <= snappedStart)
+        {
+            continue; // both ends went to the same pause, the row is better left alone
+        }
+        if (snappedStart != startMs)
+        {
+            newTimes[2 * i] = utils::format_timestamp(snappedStart);
+            ++moved;
+        }
+        if (snappedEnd != endMs)
+        {
+            newTimes[2 * i + 1] = utils::format_timestamp(snappedEnd);
+            ++moved;
+        }
+    }
+    if (moved > 0)
+    {
+        undoStack.push(new RetimeCommand(this, oldTimes, newTimes));
+    }
+    return moved;
+}
+
+// Sets all start and end times, interleaved, in one transaction; the journal gets a new snapshot
+// instead of a record per cell
+void TranscriptionManager::set_times(const QVector<QString> &times)
+{
+    begin_transaction();
+    for (qsizetype i = 0; i < transcriptionData.size(); ++i)
+    {
+        transcriptionData[i]->startTime = times[2 * i];
+        transcriptionData[i]->endTime = times[2 * i + 1];
+        for (int column = 0; column < 2; ++column)
+        {
+            QTableWidgetItem* item = tableWidget->item(i, column);
+            if (item)
+            {
+                item->setText(times[2 * i + column]);
+            }
         }
-        delete times; // Clean up the times vector
     }
+    decorate_lint_rows(linter.rebuild(transcriptionData));
+    if (journal.is_active())
+    {
+        journal.compact(transcriptionData);
+    }
+    mark_changed();
+    commit_transaction();
+}
+
+QString* TranscriptionManager::element_field(int row, int column)
+{
+    switch (column)
+    {
+    case 0:
+        return &transcriptionData[row]->startTime;
+    case 1:
+        return &transcriptionData[row]->endTime;
+    case 2:
+        return &transcriptionData[row]->text;
+    default:
+        return nullptr;
+    }
+}
+
+void TranscriptionManager::set_table_row(int row, const TranscriptionElement &element)
+{
+    tableWidget->setItem(row, 0, new QTableWidgetItem(element.startTime));
+    tableWidget->setItem(row, 1, new QTableWidgetItem(element.endTime));
+    tableWidget->setItem(row, 2, new QTableWidgetItem(element.text));
+}
+
+void TranscriptionManager::set_element_field(int row, int column, const QString &value)
+{
+    QString* field = element_field(row, column);
+    if (field == nullptr)
+    {
+        return;
+    }
+    begin_transaction();
+    *field = value;
+    if (column == 2 && !searchIndexDirty)
+    {
+        searchIndex.update_row(row, value);
+    }
+
+    // On the first redo the table already shows the typed value
+    QTableWidgetItem* item = tableWidget->item(row, column);
+    if (item && item->text() != value)
+    {
+        item->setText(value);
+    }
+    decorate_lint_rows(linter.update_row(row, *transcriptionData[row]));
+    journal.record_change(row, column, value);
+    compact_journal_if_needed();
+    mark_changed();
+    commit_transaction();
+}
+
+// Replaces count rows at row with elements in the data, the table and the lint state. Work is
+// proportional to the rows replaced; the search and segment indexes are rebuilt lazily.
+void TranscriptionManager::replace_rows(int row, int count, const QVector<TranscriptionElement> &elements)
+{
+    const int kept = qMin<int>(count, elements.size());
+    for (int i = 0; i < kept; ++i)
+    {
+        *transcriptionData[row + i] = elements[i];
+    }
+    if (count > kept)
+    {
+        for (int i = kept; i < count; ++i)
+        {
+            delete transcriptionData[row + i];
+        }
+        transcriptionData.remove(row + kept, count - kept);
+        tableWidget->model()->removeRows(row + kept, count - kept);
+    }
+    else if (elements.size() > kept)
+    {
+        transcriptionData.insert(row + kept, elements.size() - kept, nullptr);
+        for (qsizetype i = kept; i < elements.size(); ++i)
+        {
+            transcriptionData[row + i] = new TranscriptionElement(elements[i]);
+        }
+        tableWidget->model()->insertRows(row + kept, elements.size() - kept);
+    }
+    for (qsizetype i = 0; i < elements.size(); ++i)
+    {
+        set_table_row(row + i, elements[i]);
+    }
+    searchIndexDirty = true;
+    decorate_lint_rows(linter.replace_rows(row, count, elements));
 }
 
+void TranscriptionManager::insert_element(int row, const TranscriptionElement &element)
+{
+    begin_transaction();
+    replace_rows(row, 0, {element});
+    journal.record_insert(row, element);
+    compact_journal_if_needed();
+    mark_changed();
+    commit_transaction();
+}
+
+void TranscriptionManager::remove_element(int row)
+{
+    begin_transaction();
+    replace_rows(row, 1, {});
+    journal.record_remove(row);
+    compact_journal_if_needed();
+    mark_changed();
+    commit_transaction();
+}
+
+// Applies a batch of splits, touching only the rows of the split elements
+void TranscriptionManager::split_elements(const QVector<ElementSplit> &splits)
+{
+    begin_transaction();
+    qsizetype shift = 0;
+    for (const ElementSplit &split : splits)
+    {
+        // The rows of the earlier splits of the batch are already inserted
+        const int row = split.row + shift;
+        replace_rows(row, 1, split.parts);
+        journal.record_replace(row, 1, split.parts);
+        shift += split.parts.size() - 1;
+    }
+    compact_journal_if_needed();
+    mark_changed();
+    commit_transaction();
+}
+
+// Undoes split_elements(): every group of parts becomes its original element again
+void TranscriptionManager::join_elements(const QVector<ElementSplit> &splits)
+{
+    begin_transaction();
+    for (const ElementSplit &split : splits)
+    {
+        // The earlier splits are already joined, so the rows before this one are back in place
+        replace_rows(split.row, split.parts.size(), {split.original});
+        journal.record_replace(split.row, split.parts.size(), {split.original});
+    }
+    compact_journal_if_needed();
+    mark_changed();
+    commit_transaction();
+}
 
 void TranscriptionManager::update_table()
 {
@@ -180,18 +561,207 @@ qsizetype TranscriptionManager::element_count()
     return transcriptionData.count();
 }
 
+const SegmentIndex& TranscriptionManager::segment_index()
+{
+    // Rebuilt lazily so a burst of edits costs a single sort
+    if (segmentIndexDirty)
+    {
+        segmentIndex.rebuild(transcriptionData);
+        segmentIndexDirty = false;
+    }
+    return segmentIndex;
+}
+
+QVector<int> TranscriptionManager::search(const QString &query)
+{
+    // Text edits keep the index current, only row changes leave it to be rebuilt here
+    if (searchIndexDirty)
+    {
+        searchIndex.rebuild(transcriptionData);
+        searchIndexDirty = false;
+    }
+    return searchIndex.find(query);
+}
+
+// First row after the given one with a lint issue, wrapping around; -1 if there is none
+int TranscriptionManager::next_lint_issue(int row) const
+{
+    int count = transcriptionData.size();
+    for (int i = 1; i <= count; ++i)
+    {
+        int candidate = (row + i + count) % count;
+        if (linter.issues(candidate) != NoIssue)
+        {
+            return candidate;
+        }
+    }
+    return -1;
+}
+
+bool TranscriptionManager::has_journal(const QString &filePath) const
+{
+    return journal.exists(filePath);
+}
+
+// Restores the edits a session that did not exit cleanly made to filePath, returns false if its
+// journal holds nothing usable
+bool TranscriptionManager::recover_from_journal(const QString &filePath)
+{
+    QVector<TranscriptionElement> elements;
+    if (!journal.replay(filePath, elements))
+    {
+        return false;
+    }
+
+    for (TranscriptionElement* elem : transcriptionData)
+    {
+        delete elem;
+    }
+    transcriptionData.clear();
+    for (const TranscriptionElement &element : elements)
+    {
+        transcriptionData.push_back(new TranscriptionElement(element));
+    }
+    populate_table();
+    undoStack.clear();
+    journal.start(filePath, transcriptionData);
+    return true;
+}
+
+void TranscriptionManager::discard_journal()
+{
+    journal.discard();
+}
+
+void TranscriptionManager::compact_journal_if_needed()
+{
+    if (journal.needs_compaction())
+    {
+        journal.compact(transcriptionData);
+    }
+}
+
+// Shows the lint issues of the given rows as red text on the affected cells, with the
+// descriptions as the tooltip of the row
+void TranscriptionManager::decorate_lint_rows(const QVector<int> &rows)
+{
+    static const quint8 columnIssues[] = {Overlap | NegativeDuration | LongGap, NegativeDuration, ReadingSpeed | LineLength};
+    begin_transaction();
+    for (int row : rows)
+    {
+        quint8 issues = linter.issues(row);
+        QVariant toolTip = issues != NoIssue ? QVariant(TranscriptLinter::describe(issues)) : QVariant();
+        for (int column = 0; column < 3; ++column)
+        {
+            QTableWidgetItem* item = tableWidget->item(row, column);
+            if (item)
+            {
+                item->setData(Qt::ForegroundRole, (issues & columnIssues[column]) ? QVariant(QColor(Qt::red)) : QVariant());
+                item->setData(Qt::ToolTipRole, toolTip);
+            }
+        }
+    }
+    commit_transaction();
+    emit lint_changed(linter.rows_with_issues());
+}
+
+// Transactions nest; until the outermost one commits, the table's cellChanged echoes are
+// blocked, repaints are suspended and change notifications collapse into a single one
+void TranscriptionManager::begin_transaction()
+{
+    if (transactionDepth++ == 0)
+    {
+        tableSignalsBlocked = tableWidget->blockSignals(true);
+        tableWidget->setUpdatesEnabled(false);
+        changedInTransaction = false;
+    }
+}
+
+void TranscriptionManager::commit_transaction()
+{
+    if (transactionDepth == 0 || --transactionDepth > 0)
+    {
+        return;
+    }
+    tableWidget->setUpdatesEnabled(true);
+    tableWidget->blockSignals(tableSignalsBlocked);
+    if (changedInTransaction)
+    {
+        changedInTransaction = false;
+        emit transcription_changed();
+    }
+}
+
+void TranscriptionManager::mark_changed()
+{
+    segmentIndexDirty = true;
+    if (transactionDepth > 0)
+    {
+        changedInTransaction = true;
+        return;
+    }
+    emit transcription_changed();
+}
+
+// Saving takes a snapshot, formats and writes it on a worker thread and reports back with
+// transcription_saved() or transcription_save_failed(), so editing continues meanwhile
+void TranscriptionManager::save_transcription(const QString &filePath, subtitle::Format format)
+{
+    if (saveWatcher.isRunning())
+    {
+        // Only the latest request matters, it starts from a fresh snapshot once the current save is done
+        pendingSavePath = filePath;
+        pendingSaveFormat = format;
+        return;
+    }
+
+    // Copying the elements only copies implicitly shared strings, later edits detach from the snapshot
+    QVector<TranscriptionElement> snapshot;
+    snapshot.reserve(transcriptionData.size());
+    for (const TranscriptionElement* element : transcriptionData)
+    {
+        snapshot.push_back(*element);
+    }
+
+    savingPath = filePath;
+    saveWatcher.setFuture(QtConcurrent::run(write_snapshot, std::move(snapshot), filePath, format));
+}
+
+void TranscriptionManager::handle_save_finished()
+{
+    QString error = saveWatcher.result();
+    if (error.isEmpty())
+    {
+        emit transcription_saved(savingPath);
+    }
+    else
+    {
+        emit transcription_save_failed(savingPath, error);
+    }
+
+    if (!pendingSavePath.isEmpty())
+    {
+        QString filePath = pendingSavePath;
+        pendingSavePath.clear();
+        save_transcription(filePath, pendingSaveFormat);
+    }
+}
+
 void TranscriptionManager::populate_table()
 {
+    // Inside a transaction the setItem calls are not echoed back through cellChanged
+    begin_transaction();
+    searchIndexDirty = true;
     tableWidget->clearContents();
     tableWidget->setRowCount(transcriptionData.size());
-    TranscriptionElement *elem = nullptr;
     for (qsizetype i = 0; i < transcriptionData.size(); ++i)
     {
-        elem = transcriptionData[i];
-        tableWidget->setItem(i, 0, new QTableWidgetItem(elem->startTime));
-        tableWidget->setItem(i, 1, new QTableWidgetItem(elem->endTime));
-        tableWidget->setItem(i, 2, new QTableWidgetItem(elem->text));
+        set_table_row(i, *transcriptionData[i]);
     }
+    // The rows are new and undecorated, so start from a clean lint state
+    linter.clear();
+    decorate_lint_rows(linter.rebuild(transcriptionData));
     tableWidget->resizeColumnsToContents();
+    mark_changed();
+    commit_transaction();
 }
-
@@ -0,0 +1,187 @@
+#include "include/transcriptlinter.h"
+#include "include/params.h"
+#include <QObject>
+#include <QStringList>
+#include <QtConcurrent/QtConcurrentMap>
+
+quint8 TranscriptLinter::check_row(qsizetype row) const
+{
+    quint8 issues = NoIssue;
+    qint64 duration = ends[row] - starts[row];
+    if (duration < 0)
+    {
+        issues |= NegativeDuration;
+    }
+    if (row > 0)
+    {
+        qint64 gap = starts[row] - ends[row - 1];
+        if (gap < 0)
+        {
+            issues |= Overlap;
+        }
+        else if (gap > params::LINT_MAX_GAP_MS)
+        {
+            issues |= LongGap;
+        }
+    }
+    if (duration > 0 && lengths[row] * 1000.0 / duration > params::LINT_MAX_CHARS_PER_SECOND)
+    {
+        issues |= ReadingSpeed;
+    }
+    if (lengths[row] > params::MAX_CHAR_PER_LINE)
+    {
+        issues |= LineLength;
+    }
+    return issues;
+}
+
+void TranscriptLinter::set_row_data(qsizetype row, const TranscriptionElement &element)
+{
+    starts[row] = utils::convert_time_to_ms(element.startTime);
+    ends[row] = utils::convert_time_to_ms(element.endTime);
+    lengths[row] = element.text.size();
+}
+
+// Two parallel passes over chunks of rows: parse the timestamps, then check every row
+QVector<int> TranscriptLinter::rebuild(const QVector<TranscriptionElement*>& elements)
+{
+    qsizetype count = elements.size();
+    QVector<quint8> previous = flags;
+    previous.resize(count, NoIssue);
+    starts.resize(count);
+    ends.resize(count);
+    lengths.resize(count);
+    flags.resize(count);
+
+    QList<qsizetype> chunkStarts;
+    for (qsizetype first = 0; first < count; first += params::LINT_CHUNK_ROWS)
+    {
+        chunkStarts.push_back(first);
+    }
+    QtConcurrent::blockingMap(chunkStarts, [&](qsizetype first)
+    {
+        qsizetype last = qMin(first + params::LINT_CHUNK_ROWS, count);
+        for (qsizetype row = first; row < last; ++row)
+        {
+            set_row_data(row, *elements[row]);
+        }
+    });
+    QtConcurrent::blockingMap(chunkStarts, [&](qsizetype first)
+    {
+        qsizetype last = qMin(first + params::LINT_CHUNK_ROWS, count);
+        for (qsizetype row = first; row < last; ++row)
+        {
+            flags[row] = check_row(row);
+        }
+    });
+
+    QVector<int> changed;
+    issueRows = 0;
+    for (qsizetype row = 0; row < count; ++row)
+    {
+        issueRows += flags[row] != NoIssue;
+        if (flags[row] != previous[row])
+        {
+            changed.push_back(row);
+        }
+    }
+    return changed;
+}
+
+QVector<int> TranscriptLinter::update_row(int row, const TranscriptionElement &element)
+{
+    if (row < 0 || row >= flags.size())
+    {
+        return {};
+    }
+    set_row_data(row, element);
+    return recheck(row, row + 1);
+}
+
+QVector<int> TranscriptLinter::replace_rows(int row, int count, const QVector<TranscriptionElement> &elements)
+{
+    if (row < 0 || count < 0 || row + count > flags.size())
+    {
+        return {};
+    }
+    for (qsizetype i = row; i < row + count; ++i)
+    {
+        issueRows -= flags[i] != NoIssue;
+    }
+    const qsizetype added = elements.size();
+    starts.remove(row, count);
+    ends.remove(row, count);
+    lengths.remove(row, count);
+    flags.remove(row, count);
+    starts.insert(row, added, 0);
+    ends.insert(row, added, 0);
+    lengths.insert(row, added, 0);
+    flags.insert(row, added, NoIssue);
+    for (qsizetype i = 0; i < added; ++i)
+    {
+        set_row_data(row + i, elements[i]);
+    }
+    recheck(row, row + added - 1);
+
+    // The new rows are reported whether or not they have issues, since their table items are new.
+    // The rows after them keep their flags, only the first one has a new predecessor.
+    QVector<int> rows;
+    rows.reserve(added + 1);
+    for (qsizetype i = 0; i < added; ++i)
+    {
+        rows.push_back(row + i);
+    }
+    rows.append(recheck(row + added, row + added));
+    return rows;
+}
+
+void TranscriptLinter::clear()
+{
+    starts.clear();
+    ends.clear();
+    lengths.clear();
+    flags.clear();
+    issueRows = 0;
+}
+
+QVector<int> TranscriptLinter::recheck(qsizetype first, qsizetype last)
+{
+    QVector<int> changed;
+    for (qsizetype row = qMax<qsizetype>(first, 0); row <= last && row < flags.size(); ++row)
+    {
+        quint8 issues = check_row(row);
+        if (issues != flags[row])
+        {
+            issueRows += (issues != NoIssue) - (flags[row] != NoIssue);
+            flags[row] = issues;
+            changed.push_back(row);
+        }
+    }
+    return changed;
+}
+
+QString TranscriptLinter::describe(quint8 issues)
+{
+    QStringList messages;
+    if (issues & Overlap)
+    {
+        messages << QObject::tr("Overlaps the previous line");
+    }
+    if (issues & NegativeDuration)
+    {
+        messages << QObject::tr("Ends before it starts");
+    }
+    if (issues & LongGap)
+    {
+        messages << QObject::tr("Long gap after the previous line");
+    }
+    if (issues & ReadingSpeed)
+    {
+        messages << QObject::tr("Too many characters per second");
+    }
+    if (issues & LineLength)
+    {
+        messages << QObject::tr("Longer than %1 characters").arg(params::MAX_CHAR_PER_LINE);
+    }
+    return messages.join('\n');
+}
@@ -1,13 +1,9 @@
 #include "include/utils.h"
 #include "include/params.h"
+#include "include/energyenvelope.h"
+#include "subtitle.h"
 #include <QFile>
 
-static bool check_line_format(const QString &line)
-{
-    static QRegularExpression regex("^\\[\\d{2}:\\d{2}:\\d{2},\\d{3} - \\d{2}:\\d{2}:\\d{2}\\,\\d{3}]");
-    return regex.match(line).hasMatch();
-}
-
 QString utils::format_time(const qint64 ms)
 {
     int hours = (ms / (1000 * 60 * 60)) % 24;
@@ -16,14 +12,82 @@ QString utils::format_time(const qint64 ms)
     return QTime(hours, minutes, seconds).toString("HH:mm:ss");
 }
 
+static bool is_digit_at(const QString &text, qsizetype position)
+{
+    return text.at(position) >= QLatin1Char('0') && text.at(position) <= QLatin1Char('9');
+}
+
+static int digits_at(const QString &text, qsizetype position, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        value = value * 10 + (text.at(position + i).unicode() - '0');
+    }
+    return value;
+}
+
+bool utils::parse_time_ms(const QString &timeString, qint64 &ms)
+{
+    // Fast path for the "HH:MM:SS,mmm" the application writes itself, without any conversion
+    if (timeString.size() == 12 && timeString.at(2) == QLatin1Char(':') && timeString.at(5) == QLatin1Char(':') &&
+        (timeString.at(8) == QLatin1Char(',') || timeString.at(8) == QLatin1Char('.')))
+    {
+        static const qsizetype digitPositions[] = {0, 1, 3, 4, 6, 7, 9, 10, 11};
+        bool digits = true;
+        for (qsizetype position : digitPositions)
+        {
+            digits = digits && is_digit_at(timeString, position);
+        }
+        int minutes = digits_at(timeString, 3, 2);
+        int seconds = digits_at(timeString, 6, 2);
+        if (digits && minutes < 60 && seconds < 60)
+        {
+            ms = ((digits_at(timeString, 0, 2) * 60LL + minutes) * 60 + seconds) * 1000 + digits_at(timeString, 9, 3);
+            return true;
+        }
+    }
+
+    // Also accepts "HH:MM:SS" and WebVTT's "MM:SS.mmm", and hours past 23
+    std::int64_t parsed = 0;
+    if (!subtitle::parse_timestamp(timeString.toStdString(), parsed))
+    {
+        return false;
+    }
+    ms = parsed;
+    return true;
+}
+
+// Returns 0 for a time that does not parse, use parse_time_ms() where that must be told apart
 qint64 utils::convert_time_to_ms(const QString &timeString)
 {
-    QTime time = QTime::fromString(timeString, "hh:mm:ss,zzz");
-    if (!time.isValid())
+    qint64 ms = 0;
+    return parse_time_ms(timeString, ms) ? ms : 0;
+}
+
+// Formats milliseconds as "HH:MM:SS,mmm", unlike format_time() which drops the milliseconds and wraps at 24 h
+QString utils::format_timestamp(qint64 ms)
+{
+    ms = qMax<qint64>(ms, 0);
+    qint64 hours = ms / 3600000;
+    if (hours > 99)
+    {
+        return QString::fromStdString(subtitle::format_timestamp(ms));
+    }
+    const qint64 fields[] = {hours, ms / 60000 % 60, ms / 1000 % 60};
+    QString result(12, Qt::Uninitialized);
+    QChar* out = result.data();
+    for (int i = 0; i < 3; ++i)
     {
-        return 0;
+        *out++ = QLatin1Char(static_cast<char>('0' + fields[i] / 10));
+        *out++ = QLatin1Char(static_cast<char>('0' + fields[i] % 10));
+        *out++ = QLatin1Char(i < 2 ? ':' : ',');
     }
-    return QTime(0, 0).msecsTo(time);
+    qint64 millis = ms % 1000;
+    *out++ = QLatin1Char(static_cast<char>('0' + millis / 100));
+    *out++ = QLatin1Char(static_cast<char>('0' + millis / 10 % 10));
+    *out = QLatin1Char(static_cast<char>('0' + millis % 10));
+    return result;
 }
 
 qint64 utils::extract_start_time(const QString &text)
@@ -115,19 +179,47 @@ QStringList utils::split_text_into_lines(const QString& text, int maxLength)
     return lines;
 }
 
-std::vector<std::pair<QString, QString>>* utils::adjust_timestamp(const QString& startTime, const QString& endTime, int totalLines)
+// Divides the time of an element among its lines in proportion to their length. With an energy
+// envelope each boundary moves to the quietest frame near its proportional position, where the
+// pause between the words most likely is; a boundary never passes the previous one or the
+// proportional position of the next.
+std::vector<std::pair<QString, QString>>* utils::adjust_timestamp(const QString& startTime, const QString& endTime, const QStringList& lines, const EnergyEnvelope* envelope)
 {
     qint64 startMs = utils::convert_time_to_ms(startTime);
     qint64 endMs = utils::convert_time_to_ms(endTime);
     qint64 totalDuration = endMs - startMs;
-    qint64 segmentDuration = totalDuration / totalLines;
+    qint64 totalLength = 0;
+    for (const QString& line : lines)
+    {
+        totalLength += line.length();
+    }
+    totalLength = qMax<qint64>(totalLength, 1);
+    bool snap = envelope != nullptr && !envelope->is_empty() && totalDuration > 0;
 
     std::vector<std::pair<QString, QString>>* times = new std::vector<std::pair<QString, QString>>();
 
-    for (int i = 0; i < totalLines; ++i)
+    qint64 previous = startMs;
+    qint64 length = 0;
+    for (int i = 0; i < lines.size(); ++i)
     {
-        times->push_back(std::make_pair(utils::format_time(startMs), utils::format_time(startMs + segmentDuration)));
-        startMs += segmentDuration;
+        length += lines[i].length();
+        qint64 boundary = endMs;
+        if (i + 1 < lines.size())
+        {
+            boundary = startMs + totalDuration * length / totalLength;
+            if (snap)
+            {
+                qint64 next = startMs + totalDuration * (length + lines[i + 1].length()) / totalLength;
+                qint64 from = qMax(previous + 1, boundary - params::SPLIT_SEARCH_WINDOW_MS);
+                qint64 to = qMin(next - 1, boundary + params::SPLIT_SEARCH_WINDOW_MS);
+                if (from < to)
+                {
+                    boundary = envelope->quietest_point(from, to, boundary);
+                }
+            }
+        }
+        times->push_back(std::make_pair(utils::format_timestamp(previous), utils::format_timestamp(boundary)));
+        previous = boundary;
     }
     return times;
 }
@@ -145,18 +237,14 @@ QString utils::select_file_type()
 
 bool utils::check_transcription_format(const QString& filePath)
 {
-    bool isValidFormat = true;
     QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
-    {
-        isValidFormat = false;
-    }
-    QTextStream in(&file);
-    while (!in.atEnd() && isValidFormat)
+    if (!file.open(QIODevice::ReadOnly))
     {
-        QString line = in.readLine();
-        isValidFormat = check_line_format(line);
+        return false;
     }
+    // Bracketed transcriptions, SRT and WebVTT are recognized from their first lines
+    QByteArray head = file.peek(params::FORMAT_DETECTION_SIZE);
     file.close();
-    return isValidFormat;
+    return head.trimmed().isEmpty() ||
+           subtitle::detect_format(std::string_view(head.constData(), head.size())) != subtitle::Format::Unknown;
 }
@@ -0,0 +1,111 @@
+#include "include/voiceactivity.h"
+#include "include/params.h"
+#include <algorithm>
+
+void VoiceActivity::detect(const EnergyEnvelope& envelope)
+{
+    intervals.clear();
+    const QVector<float>& energy = envelope.energies();
+    const QVector<float>& crossingRate = envelope.crossing_rates();
+    if (energy.isEmpty())
+    {
+        return;
+    }
+
+    // The noise floor is a low percentile of the frame energies, a partial sort finds it in linear time
+    QVector<float> sorted = energy;
+    auto floorFrame = sorted.begin() + sorted.size() * params::VAD_NOISE_PERCENTILE / 100;
+    std::nth_element(sorted.begin(), floorFrame, sorted.end());
+    float noiseFloor = qMax(*floorFrame, params::VAD_MIN_ENERGY);
+    float speechThreshold = noiseFloor * params::VAD_SPEECH_RATIO;
+    float fricativeThreshold = noiseFloor * params::VAD_FRICATIVE_RATIO;
+
+    qint64 start = -1;
+    for (qsizetype frame = 0; frame <= energy.size(); ++frame)
+    {
+        bool speech = frame < energy.size() &&
+                      (energy[frame] > speechThreshold ||
+                       (energy[frame] > fricativeThreshold && crossingRate[frame] > params::VAD_FRICATIVE_CROSSING_RATE));
+        qint64 timeMs = frame * params::ENERGY_FRAME_MS;
+        if (speech && start < 0)
+        {
+            start = timeMs;
+        }
+        else if (!speech && start >= 0)
+        {
+            // Pauses shorter than a breath join the speech around them
+            if (!intervals.isEmpty() && start - intervals.last().endMs < params::VAD_MIN_SILENCE_MS)
+            {
+                intervals.last().endMs = timeMs;
+            }
+            else
+            {
+                intervals.push_back({start, timeMs});
+            }
+            start = -1;
+        }
+    }
+
+    intervals.erase(std::remove_if(intervals.begin(), intervals.end(), [](const SpeechInterval& interval) {
+        return interval.endMs - interval.startMs < params::VAD_MIN_SPEECH_MS;
+    }), intervals.end());
+}
+
+// Where playback should continue from timeMs to hear speech: timeMs itself inside speech, the
+// start of the next interval inside silence, or -1 if no speech follows
+qint64 VoiceActivity::next_speech(qint64 timeMs) const
+{
+    auto next = std::lower_bound(intervals.cbegin(), intervals.cend(), timeMs, [](const SpeechInterval& interval, qint64 time) {
+        return interval.endMs <= time;
+    });
+    if (next == intervals.cend())
+    {
+        return -1;
+    }
+    return qMax(timeMs, next->startMs);
+}
+
+// Nearest speech start (or end) within maxDistanceMs of timeMs, timeMs itself if there is none
+qint64 VoiceActivity::snap_to_boundary(qint64 timeMs, bool start, qint64 maxDistanceMs) const
+{
+    auto next = std::lower_bound(intervals.cbegin(), intervals.cend(), timeMs, [start](const SpeechInterval& interval, qint64 time) {
+        return (start ? interval.startMs : interval.endMs) < time;
+    });
+    qsizetype nextIndex = next - intervals.cbegin();
+    qint64 best = timeMs;
+    qint64 bestDistance = maxDistanceMs + 1;
+    for (qsizetype i = qMax<qsizetype>(nextIndex - 1, 0); i <= nextIndex && i < intervals.size(); ++i)
+    {
+        qint64 boundary = start ? intervals[i].startMs : intervals[i].endMs;
+        if (qAbs(boundary - timeMs) < bestDistance)
+        {
+            best = boundary;
+            bestDistance = qAbs(boundary - timeMs);
+        }
+    }
+    return best;
+}
+
+// The parts of the detected speech that no transcript segment covers
+QVector<SpeechInterval> VoiceActivity::untranscribed(const SegmentIndex& segments) const
+{
+    QVector<SpeechInterval> result;
+    for (const SpeechInterval& interval : intervals)
+    {
+        // Spans come sorted by start, so the uncovered parts are the holes left walking through them
+        qint64 position = interval.startMs;
+        for (const SegmentSpan& span : segments.query(interval.startMs, interval.endMs))
+        {
+            if (span.startMs - position >= params::VAD_MIN_SPEECH_MS)
+            {
+                result.push_back({position, span.startMs});
+            }
+            position = qMax(position, span.endMs);
+        }
+        if (interval.endMs - position >= params::VAD_MIN_SPEECH_MS)
+        {
+            result.push_back({position, interval.endMs});
+        }
+    }
+    return result;
+}
@@ -1,16 +1,63 @@
 #include "include/waveform.h"
 #include <QtGlobal>
+#include <algorithm>
 
-constexpr int UPDATE_INTERVAL_MS = 600;
+constexpr int TIME_WINDOW = 10;             // seconds visible in the detail view before zooming
+constexpr double PAGE_LEAD_FRACTION = 0.25; // where the marker lands after the window scrolls
+constexpr double PAGE_TURN_FRACTION = 0.9;  // how far the marker travels before the window scrolls
+constexpr int PEAK_BUCKET_SIZE = 64;        // samples per bucket in the finest peak level
+constexpr int OVERVIEW_BUCKETS = 2048;      // resolution of the whole-file overview strip
+constexpr int MIN_VIEW_SAMPLES = 256;       // maximum zoom-in
+constexpr int MAX_DRAWN_SEGMENTS = 1000;    // zoomed out further than this, segments are not shaded
+
+// Appends the mean of the channels of every frame, shifted by offset and scaled into [-1, 1]
+template <typename Sample>
+static void append_frames(QVector<double>& samples, const Sample* data, qsizetype frameCount, int channelCount,
+                          double offset, double scale)
+{
+    if (!data)
+    {
+        qWarning("Buffer data is null.");
+        return;
+    }
+    const double frameScale = scale / channelCount;
+    for (qsizetype frame = 0; frame < frameCount; ++frame)
+    {
+        const Sample* values = data + frame * channelCount;
+        double sum = 0;
+        for (int channel = 0; channel < channelCount; ++channel)
+        {
+            sum += values[channel];
+        }
+        samples.append((sum - offset * channelCount) * frameScale);
+    }
+}
 
 Waveform::Waveform(MediaControl* mediaControl, QWidget *parent) : QCustomPlot(parent)
     , decoder(new QAudioDecoder(this)), marker(new QCPItemLine(this))
-    , durationMs(0), sampleRate(0)
+    , durationMs(0), sampleRate(0), plottedLevel(-1), plottedStart(0), plottedEnd(0)
+    , viewStart(-1), viewWidth(0), followPlayhead(true), updatingView(false)
+    , playing(false), lastReportedPosition(0), playbackRate(1.0)
     , mediaControl(mediaControl)
 {
     configure_waveform_appearance();
-    initialize_timer();
+    configure_overview();
     connect(decoder, &QAudioDecoder::bufferReady, this, &Waveform::set_buffer);
+    connect(decoder, &QAudioDecoder::finished, this, &Waveform::build_peaks);
+    connect(xAxis, QOverload<const QCPRange&>::of(&QCPAxis::rangeChanged), this, &Waveform::handle_view_range_changed);
+    connect(this, &QCustomPlot::mousePress, this, &Waveform::handle_mouse_press);
+    connect(this, &QCustomPlot::mouseDoubleClick, this, [this](QMouseEvent*) {
+        followPlayhead = true;
+        update_waveform(this->mediaControl->get_position());
+    });
+
+    QMediaPlayer* player = mediaControl->get_media_player();
+    connect(player, &QMediaPlayer::positionChanged, this, &Waveform::sync_position);
+    connect(player, &QMediaPlayer::playbackStateChanged, this, &Waveform::handle_playback_state_changed);
+    connect(player, &QMediaPlayer::playbackRateChanged, this, [this](qreal rate) {
+        sync_position(this->mediaControl->get_position());
+        playbackRate = rate;
+    });
 }
 
 Waveform::~Waveform()
@@ -19,17 +66,40 @@ Waveform::~Waveform()
         decoder->stop();
     }
     delete decoder;
-    delete updateTimer;
 }
 
 void Waveform::set_source(const QString& fileName)
 {
     samples.clear();
+    peakLevels.clear();
+    envelope.clear();
+    voiceActivity.clear();
+    untranscribedSpeech.clear();
+    wavePlot->data()->clear();
+    overviewPlot->data()->clear();
+    sampleRate = 0;
+    plottedLevel = -1;
+    plottedStart = 0;
+    plottedEnd = 0;
+    viewStart = -1;
+    viewWidth = 0;
+    followPlayhead = true;
     decoder->setSource(QUrl::fromLocalFile(fileName));
     decoder->start();
     durationMs = decoder->duration();
 }
 
+void Waveform::set_segments(const SegmentIndex& index)
+{
+    segments = index;
+    untranscribedSpeech = voiceActivity.untranscribed(segments);
+    if (viewStart >= 0)
+    {
+        draw_segments();
+        replot(QCustomPlot::rpQueuedReplot);
+    }
+}
+
 void Waveform::set_buffer()
 {
     if (!decoder->bufferAvailable())
@@ -43,108 +113,457 @@ void Waveform::set_buffer()
     if (sampleRate == 0)
     {
         sampleRate = buffer.format().sampleRate();
+        viewWidth = sampleRate * TIME_WINDOW;
     }
 
-    qreal peak = get_peak_value(buffer.format());
-    const qint16 *data = buffer.constData<qint16>();
-    if (!data)
+    // One value per frame, the mean of its channels, so peaks, energy and speech detection all
+    // see the same mono signal whatever the layout and sample format of the decoder output
+    const QAudioFormat format = buffer.format();
+    const int channelCount = qMax(format.channelCount(), 1);
+    const qsizetype frameCount = buffer.frameCount();
+    switch (format.sampleFormat())
+    {
+    case QAudioFormat::UInt8:
+        append_frames(samples, buffer.constData<quint8>(), frameCount, channelCount, 128.0, 1.0 / 128);
+        break;
+    case QAudioFormat::Int16:
+        append_frames(samples, buffer.constData<qint16>(), frameCount, channelCount, 0.0, 1.0 / 32768);
+        break;
+    case QAudioFormat::Int32:
+        append_frames(samples, buffer.constData<qint32>(), frameCount, channelCount, 0.0, 1.0 / 2147483648.0);
+        break;
+    case QAudioFormat::Float:
+        append_frames(samples, buffer.constData<float>(), frameCount, channelCount, 0.0, 1.0);
+        break;
+    default:
+        qWarning("Unknown audio sample format");
+        break;
+    }
+}
+
+void Waveform::build_peaks()
+{
+    // Min/max pyramid: level 0 summarizes PEAK_BUCKET_SIZE samples per bucket, every
+    // further level halves the bucket count, so any zoom draws about one bucket per pixel
+    peakLevels.clear();
+    if (samples.isEmpty())
+    {
+        return;
+    }
+
+    PeakLevel base;
+    base.bucketSize = PEAK_BUCKET_SIZE;
+    qsizetype bucketCount = (samples.size() + PEAK_BUCKET_SIZE - 1) / PEAK_BUCKET_SIZE;
+    base.minima.resize(bucketCount);
+    base.maxima.resize(bucketCount);
+    for (qsizetype b = 0; b < bucketCount; ++b)
+    {
+        qsizetype from = b * PEAK_BUCKET_SIZE;
+        qsizetype to = qMin(from + PEAK_BUCKET_SIZE, samples.size());
+        double low = samples[from];
+        double high = samples[from];
+        for (qsizetype i = from + 1; i < to; ++i)
+        {
+            low = qMin(low, samples[i]);
+            high = qMax(high, samples[i]);
+        }
+        base.minima[b] = low;
+        base.maxima[b] = high;
+    }
+    peakLevels.append(base);
+
+    while (peakLevels.last().minima.size() > 1)
+    {
+        const PeakLevel& previous = peakLevels.last();
+        PeakLevel next;
+        next.bucketSize = previous.bucketSize * 2;
+        qsizetype count = (previous.minima.size() + 1) / 2;
+        next.minima.resize(count);
+        next.maxima.resize(count);
+        for (qsizetype b = 0; b < count; ++b)
+        {
+            qsizetype left = 2 * b;
+            qsizetype right = qMin(left + 1, previous.minima.size() - 1);
+            next.minima[b] = qMin(previous.minima[left], previous.minima[right]);
+            next.maxima[b] = qMax(previous.maxima[left], previous.maxima[right]);
+        }
+        peakLevels.append(next);
+    }
+
+    envelope.build(samples, sampleRate);
+    voiceActivity.detect(envelope);
+    untranscribedSpeech = voiceActivity.untranscribed(segments);
+
+    durationMs = samples.size() * 1000 / sampleRate;
+    draw_overview();
+    plottedStart = plottedEnd = 0; // force the detail view onto the new levels
+    update_waveform(mediaControl->get_position());
+}
+
+void Waveform::sync_position(qint64 positionMs)
+{
+    lastReportedPosition = positionMs;
+    positionClock.restart();
+    if (!playing)
+    {
+        // Paused or stopped: this is a seek, draw it once and go back to idle
+        update_waveform(positionMs);
+    }
+    else
+    {
+        // Restarts the frame loop if the window was hidden or recreated since the last frame
+        request_frame();
+    }
+}
+
+void Waveform::handle_playback_state_changed(QMediaPlayer::PlaybackState state)
+{
+    playing = state == QMediaPlayer::PlayingState;
+    if (playing)
+    {
+        sync_position(mediaControl->get_position());
+    }
+    else
+    {
+        update_waveform(mediaControl->get_position());
+    }
+}
+
+void Waveform::handle_view_range_changed(const QCPRange& newRange)
+{
+    if (updatingView || sampleRate == 0 || samples.isEmpty())
     {
-        qWarning("Buffer data is null.");
         return;
     }
 
-    int channelCount = buffer.format().channelCount();
-    int count = buffer.sampleCount() / channelCount;
-    for (int i = 0; i < count; ++i)
+    // The user zoomed (wheel) or panned (drag) the detail view
+    viewWidth = qBound(MIN_VIEW_SAMPLES, static_cast<int>(newRange.size()), static_cast<int>(samples.size()));
+    viewStart = qBound(0, static_cast<int>(newRange.lower), static_cast<int>(samples.size()) - viewWidth);
+    redraw_view();
+    replot(QCustomPlot::rpQueuedReplot);
+}
+
+void Waveform::handle_mouse_press(QMouseEvent* event)
+{
+    if (sampleRate == 0)
     {
-        samples.append(data[i] / peak);
+        return;
+    }
+
+    if (overviewRect->rect().contains(event->pos()))
+    {
+        // Clicking the overview seeks there and goes back to following the playhead
+        double sampleIndex = overviewRect->axis(QCPAxis::atBottom)->pixelToCoord(event->pos().x());
+        followPlayhead = true;
+        viewStart = -1;
+        mediaControl->set_position(qMax(0.0, sampleIndex) * 1000 / sampleRate);
+    }
+    else if (axisRect()->rect().contains(event->pos()))
+    {
+        // Grabbing the detail view to pan it: stop scrolling it under the user's hand
+        followPlayhead = false;
     }
 }
 
+void Waveform::render_frame()
+{
+    // Extrapolate from the last position reported by the player, which only arrives every few frames
+    qint64 positionMs = lastReportedPosition + qRound64(positionClock.elapsed() * playbackRate);
+    if (durationMs > 0)
+    {
+        positionMs = qMin(positionMs, durationMs);
+    }
+    move_marker(positionMs);
+}
+
+void Waveform::move_marker(qint64 currentTimeMs)
+{
+    if (sampleRate == 0 || samples.isEmpty())
+    {
+        return;
+    }
+
+    int currentSampleIndex = (currentTimeMs / 1000.0) * sampleRate;
+    int windowEnd = qMin(samples.size(), viewStart + viewWidth);
+    int plottedSampleEnd = plottedEnd * bucket_size(plottedLevel);
+    if ((followPlayhead && !is_in_page(currentSampleIndex)) || plottedSampleEnd < windowEnd)
+    {
+        // The window has to scroll (or more audio was decoded): full redraw
+        update_waveform(currentTimeMs);
+        return;
+    }
+
+    set_marker(currentSampleIndex);
+    layer(QStringLiteral("marker"))->replot();
+}
+
+bool Waveform::is_in_page(int sampleIndex) const
+{
+    return viewStart >= 0
+           && sampleIndex >= viewStart
+           && sampleIndex <= viewStart + viewWidth * PAGE_TURN_FRACTION;
+}
+
 void Waveform::update_waveform(qint64 currentTimeMs)
 {
     if (sampleRate == 0 || samples.isEmpty())
     {
-        qWarning("Sample rate is zero or no samples are loaded.");
+        return; // Nothing decoded yet
     }
-    else
+
+    int currentSampleIndex = (currentTimeMs / 1000.0) * sampleRate;
+
+    // Scroll by pages so that most frames only have to move the marker
+    if (viewStart < 0 || (followPlayhead && !is_in_page(currentSampleIndex)))
     {
-        constexpr int TIME_WINDOW = 10; // seconds
-        int timeWindowSamples = sampleRate * TIME_WINDOW;
+        viewStart = qMax(0, currentSampleIndex - static_cast<int>(viewWidth * PAGE_LEAD_FRACTION));
+    }
+    redraw_view();
+    set_marker(currentSampleIndex);
 
-        int centerSampleIndex = (currentTimeMs / 1000.0) * sampleRate;
-        int startSampleIndex = qMax(0, centerSampleIndex - timeWindowSamples / 2);
-        int endSampleIndex = qMin(samples.size(), centerSampleIndex + timeWindowSamples / 2);
+    // Coalesce with any other pending repaint instead of drawing synchronously
+    replot(QCustomPlot::rpQueuedReplot);
+}
 
-        QVector<double> xValues, segmentSamples;
-        xValues.reserve(endSampleIndex - startSampleIndex);
-        segmentSamples.reserve(endSampleIndex - startSampleIndex);
-        for (int i = startSampleIndex; i < endSampleIndex; ++i)
+void Waveform::redraw_view()
+{
+    int level = choose_level();
+    int unit = bucket_size(level);
+    int unitCount = level < 0 ? samples.size() : peakLevels[level].minima.size();
+    int startUnit = viewStart / unit;
+    int endUnit = qMin(unitCount, (viewStart + viewWidth + unit - 1) / unit);
+    if (startUnit >= endUnit)
+    {
+        return;
+    }
+
+    bool overlapsPlotted = level == plottedLevel && plottedStart < plottedEnd
+                           && startUnit < plottedEnd && endUnit > plottedStart;
+    if (!overlapsPlotted)
+    {
+        // Seek, zoom or first draw: the old window is useless, rebuild it
+        wavePlot->data()->clear();
+        append_units(level, startUnit, endUnit);
+    }
+    else
+    {
+        // Drop the data that scrolled out of the window...
+        if (startUnit > plottedStart)
+        {
+            wavePlot->data()->removeBefore(static_cast<double>(startUnit) * unit);
+        }
+        if (endUnit < plottedEnd)
+        {
+            wavePlot->data()->removeAfter(static_cast<double>(endUnit) * unit - 1);
+        }
+        // ...and add only what scrolled in at the edges
+        if (startUnit < plottedStart)
         {
-            xValues.append(i);
-            segmentSamples.append(samples[i]);
+            append_units(level, startUnit, plottedStart);
         }
+        if (endUnit > plottedEnd)
+        {
+            append_units(level, plottedEnd, endUnit);
+        }
+    }
+    plottedLevel = level;
+    plottedStart = startUnit;
+    plottedEnd = endUnit;
 
-        // Plot the extracted segment
-        wavePlot->data()->clear();
-        wavePlot->addData(xValues, segmentSamples);
-        xAxis->setRange(xValues.first(), xValues.last());
-        yAxis->setRange(QCPRange(-1, 1));
+    updatingView = true;
+    xAxis->setRange(viewStart, viewStart + viewWidth - 1);
+    updatingView = false;
+
+    overviewWindow->topLeft->setCoords(viewStart, 1);
+    overviewWindow->bottomRight->setCoords(viewStart + viewWidth, -1);
 
-        // Set the marker to the actual current playback sample index
-        marker->start->setCoords(centerSampleIndex, -1);
-        marker->end->setCoords(centerSampleIndex, 1);
+    draw_segments();
+}
 
-        replot();
+int Waveform::choose_level() const
+{
+    // Raw samples while zoomed in, otherwise the coarsest level that still has a bucket per pixel
+    int samplesPerPixel = viewWidth / qMax(1, axisRect()->width());
+    int level = -1;
+    while (level + 1 < peakLevels.size() && peakLevels[level + 1].bucketSize <= samplesPerPixel)
+    {
+        ++level;
     }
+    return level;
 }
 
-qreal Waveform::get_peak_value(const QAudioFormat& format)
+int Waveform::bucket_size(int level) const
 {
-    qreal result = 0;
-    QAudioFormat::SampleFormat sampleFormat = format.sampleFormat();
-    switch(sampleFormat)
+    return level < 0 ? 1 : peakLevels[level].bucketSize;
+}
+
+void Waveform::append_units(int level, int from, int to)
+{
+    if (level < 0)
     {
-    case QAudioFormat::UInt8:
-        result = 255;
-        break;
-    case QAudioFormat::Int16:
-        result = 32767;
-        break;
-    case QAudioFormat::Int32:
-        result = 2147483647;
-        break;
-    case QAudioFormat::Float:
-        result = 1.0f;
-        break;
-    case QAudioFormat::Unknown:
-        qWarning("Unknown audio sample format");
-        result = 0;
-        break;
-    default:
-        qWarning("Error getting the peak value of the samples");
-        break;
+        QVector<QCPGraphData> points(to - from);
+        for (int i = from; i < to; ++i)
+        {
+            points[i - from].key = i;
+            points[i - from].value = samples[i];
+        }
+        wavePlot->data()->add(points, true);
+        return;
+    }
+
+    // Each bucket becomes a min and a max point, which the line joins into an envelope
+    const PeakLevel& peaks = peakLevels[level];
+    QVector<QCPGraphData> points(2 * (to - from));
+    for (int b = from; b < to; ++b)
+    {
+        double key = static_cast<double>(b) * peaks.bucketSize;
+        points[2 * (b - from)] = QCPGraphData(key, peaks.minima[b]);
+        points[2 * (b - from) + 1] = QCPGraphData(key + peaks.bucketSize / 2, peaks.maxima[b]);
     }
-    return result;
+    wavePlot->data()->add(points, true);
 }
 
-void Waveform::initialize_timer()
+void Waveform::set_marker(int sampleIndex)
 {
-    updateTimer = new QTimer(this);
-    connect(updateTimer, &QTimer::timeout, this, [this]() {
-        update_waveform(this->mediaControl->get_position());
+    marker->start->setCoords(sampleIndex, -1);
+    marker->end->setCoords(sampleIndex, 1);
+    overviewMarker->start->setCoords(sampleIndex, -1);
+    overviewMarker->end->setCoords(sampleIndex, 1);
+}
+
+void Waveform::draw_segments()
+{
+    qint64 fromMs = static_cast<qint64>(viewStart) * 1000 / sampleRate;
+    qint64 toMs = static_cast<qint64>(viewStart + viewWidth) * 1000 / sampleRate;
+    QVector<SegmentSpan> visible = segments.query(fromMs, toMs);
+    if (visible.size() > MAX_DRAWN_SEGMENTS)
+    {
+        visible.clear();
+    }
+
+    for (qsizetype i = 0; i < visible.size(); ++i)
+    {
+        QCPItemRect* item = reuse_item(segmentItems, i);
+        const SegmentSpan& span = visible[i];
+        item->topLeft->setCoords(span.startMs * sampleRate / 1000.0, 1);
+        item->bottomRight->setCoords(span.endMs * sampleRate / 1000.0, -1);
+        // Alternate colors so that back-to-back segments stay distinguishable
+        item->setBrush(span.row % 2 == 0 ? QBrush(QColor(255, 190, 0, 45)) : QBrush(QColor(0, 170, 120, 45)));
+    }
+    for (qsizetype i = visible.size(); i < segmentItems.size(); ++i)
+    {
+        segmentItems[i]->setVisible(false);
+    }
+
+    draw_untranscribed_speech(fromMs, toMs);
+}
+
+// Speech the voice activity detection found where no segment is, as a red band at the bottom
+void Waveform::draw_untranscribed_speech(qint64 fromMs, qint64 toMs)
+{
+    // The intervals are sorted and disjoint, so their ends are sorted too
+    auto first = std::upper_bound(untranscribedSpeech.cbegin(), untranscribedSpeech.cend(), fromMs, [](qint64 time, const SpeechInterval& interval) {
+        return time < interval.endMs;
     });
-    updateTimer->start(UPDATE_INTERVAL_MS);
+    qsizetype count = 0;
+    for (auto it = first; it != untranscribedSpeech.cend() && it->startMs < toMs && count < MAX_DRAWN_SEGMENTS; ++it, ++count)
+    {
+        QCPItemRect* item = reuse_item(speechItems, count);
+        item->topLeft->setCoords(it->startMs * sampleRate / 1000.0, -0.85);
+        item->bottomRight->setCoords(it->endMs * sampleRate / 1000.0, -1);
+        item->setBrush(QBrush(QColor(220, 40, 40, 110)));
+    }
+    for (qsizetype i = count; i < speechItems.size(); ++i)
+    {
+        speechItems[i]->setVisible(false);
+    }
+}
+
+QCPItemRect* Waveform::reuse_item(QVector<QCPItemRect*>& items, qsizetype index)
+{
+    if (index == items.size())
+    {
+        QCPItemRect* item = new QCPItemRect(this);
+        item->setLayer(QStringLiteral("segments"));
+        item->setPen(Qt::NoPen);
+        items.append(item);
+    }
+    items[index]->setVisible(true);
+    return items[index];
+}
+
+void Waveform::draw_overview()
+{
+    // Use the finest level that still fits the overview resolution; drawn once per file
+    int level = 0;
+    while (level + 1 < peakLevels.size() && peakLevels[level + 1].minima.size() >= OVERVIEW_BUCKETS)
+    {
+        ++level;
+    }
+    const PeakLevel& peaks = peakLevels[level];
+    QVector<QCPGraphData> points(2 * peaks.minima.size());
+    for (qsizetype b = 0; b < peaks.minima.size(); ++b)
+    {
+        double key = static_cast<double>(b) * peaks.bucketSize;
+        points[2 * b] = QCPGraphData(key, peaks.minima[b]);
+        points[2 * b + 1] = QCPGraphData(key + peaks.bucketSize / 2, peaks.maxima[b]);
+    }
+    overviewPlot->data()->set(points, true);
+    overviewRect->axis(QCPAxis::atBottom)->setRange(0, samples.size());
+}
+
+// Asks the window for its next frame. The window system paces these requests to the display
+// refresh where it can, so the marker moves once per frame while the media plays, and not at all
+// while it is paused.
+void Waveform::request_frame()
+{
+    QWindow* handle = window()->windowHandle();
+    if (!handle)
+    {
+        return; // not shown yet, the next position report tries again
+    }
+    if (handle != frameWindow)
+    {
+        if (frameWindow)
+        {
+            frameWindow->removeEventFilter(this);
+        }
+        handle->installEventFilter(this);
+        frameWindow = handle;
+    }
+    handle->requestUpdate();
+}
+
+// The marker is moved just before the window paints the frame it was requested for
+bool Waveform::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == frameWindow && event->type() == QEvent::UpdateRequest && playing)
+    {
+        render_frame();
+        request_frame();
+    }
+    return QCustomPlot::eventFilter(watched, event);
 }
 
 void Waveform::configure_waveform_appearance()
 {
+    // The marker gets its own buffered layer so it can move without repainting the waveform
+    addLayer(QStringLiteral("marker"), layer(QStringLiteral("main")), QCustomPlot::limAbove);
+    layer(QStringLiteral("marker"))->setMode(QCPLayer::lmBuffered);
+    marker->setLayer(QStringLiteral("marker"));
+    addLayer(QStringLiteral("segments"), layer(QStringLiteral("main")), QCustomPlot::limBelow);
     marker->setPen(QPen(Qt::red));
     marker->start->setCoords(0, -1);
     marker->end->setCoords(0, 1);
     wavePlot = addGraph();
+    yAxis->setRange(QCPRange(-1, 1));
+
+    // Wheel zooms and dragging pans the detail view, horizontally only
+    setInteractions(QCP::iRangeDrag | QCP::iRangeZoom);
+    axisRect()->setRangeDrag(Qt::Horizontal);
+    axisRect()->setRangeZoom(Qt::Horizontal);
 
-    setMinimumHeight(50);
+    setMinimumHeight(80);
     setMinimumWidth(1000);
     xAxis->setVisible(false);
     yAxis->setVisible(false);
@@ -153,3 +572,39 @@ void Waveform::configure_waveform_appearance()
     axisRect()->setMargins(QMargins(0, 0, 0, 0));
     setBackground(QBrush(Qt::transparent));
 }
+
+void Waveform::configure_overview()
+{
+    overviewRect = new QCPAxisRect(this);
+    plotLayout()->addElement(1, 0, overviewRect);
+    plotLayout()->setRowStretchFactors({3, 1});
+    overviewRect->setMargins(QMargins(0, 0, 0, 0));
+    overviewRect->setAutoMargins(QCP::msNone);
+    overviewRect->setRangeDrag(Qt::Orientations());
+    overviewRect->setRangeZoom(Qt::Orientations());
+
+    QCPAxis* overviewX = overviewRect->axis(QCPAxis::atBottom);
+    QCPAxis* overviewY = overviewRect->axis(QCPAxis::atLeft);
+    overviewX->setVisible(false);
+    overviewY->setVisible(false);
+    overviewX->grid()->setVisible(false);
+    overviewY->grid()->setVisible(false);
+    overviewY->setRange(QCPRange(-1, 1));
+    overviewPlot = addGraph(overviewX, overviewY);
+    overviewPlot->setPen(QPen(Qt::gray));
+
+    // Shaded box showing which part of the file the detail view covers
+    overviewWindow = new QCPItemRect(this);
+    overviewWindow->setClipAxisRect(overviewRect);
+    overviewWindow->topLeft->setAxes(overviewX, overviewY);
+    overviewWindow->bottomRight->setAxes(overviewX, overviewY);
+    overviewWindow->setPen(QPen(QColor(0, 120, 215)));
+    overviewWindow->setBrush(QBrush(QColor(0, 120, 215, 40)));
+
+    overviewMarker = new QCPItemLine(this);
+    overviewMarker->setLayer(QStringLiteral("marker"));
+    overviewMarker->setClipAxisRect(overviewRect);
+    overviewMarker->start->setAxes(overviewX, overviewY);
+    overviewMarker->end->setAxes(overviewX, overviewY);
+    overviewMarker->setPen(QPen(Qt::red));
+}
@@ -0,0 +1,9 @@
+include(../tests.pri)
+
+TARGET = tst_editjournal
+
+SOURCES += \
+    $$PWD/../../src/editjournal.cpp \
+    tst_editjournal.cpp
+
+HEADERS += $$PWD/../../include/editjournal.h
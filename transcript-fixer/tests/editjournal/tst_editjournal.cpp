@@ -0,0 +1,122 @@
+#include "include/editjournal.h"
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtTest>
+
+class TestEditJournal : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void replay_applies_records();
+    void replay_stops_at_truncated_record();
+    void truncated_snapshot_is_not_recovered();
+    void other_file_is_not_recovered();
+
+private:
+    QTemporaryDir directory;
+    QString source;
+    QVector<TranscriptionElement> rows;
+
+    QVector<TranscriptionElement*> pointers();
+};
+
+QVector<TranscriptionElement*> TestEditJournal::pointers()
+{
+    QVector<TranscriptionElement*> elements;
+    for (TranscriptionElement& row : rows)
+    {
+        elements.push_back(&row);
+    }
+    return elements;
+}
+
+// Every test writes the journal of the same transcription, starting from two rows
+void TestEditJournal::init()
+{
+    QVERIFY(directory.isValid());
+    source = directory.filePath(QStringLiteral("talk.srt"));
+    rows = {
+        {QStringLiteral("00:00:01,000"), QStringLiteral("00:00:02,000"), QStringLiteral("one")},
+        {QStringLiteral("00:00:02,000"), QStringLiteral("00:00:03,000"), QStringLiteral("two")}};
+}
+
+void TestEditJournal::replay_applies_records()
+{
+    {
+        EditJournal journal(directory.path());
+        journal.start(source, pointers());
+        journal.record_change(0, 2, QStringLiteral("uno"));
+        journal.record_insert(1, {QStringLiteral("00:00:01,500"), QStringLiteral("00:00:02,000"), QStringLiteral("half")});
+        journal.record_remove(2);
+        journal.record_replace(0, 1, {{QStringLiteral("00:00:01,000"), QStringLiteral("00:00:01,200"), QStringLiteral("u")},
+                                      {QStringLiteral("00:00:01,200"), QStringLiteral("00:00:02,000"), QStringLiteral("no")}});
+    }   // the journal stays on disk, as after a crash
+
+    EditJournal recovery(directory.path());
+    QVERIFY(recovery.exists(source));
+    QVector<TranscriptionElement> replayed;
+    QVERIFY(recovery.replay(source, replayed));
+    QCOMPARE(replayed.size(), qsizetype(3));
+    QCOMPARE(replayed[0].text, QStringLiteral("u"));
+    QCOMPARE(replayed[1].startTime, QStringLiteral("00:00:01,200"));
+    QCOMPARE(replayed[1].text, QStringLiteral("no"));
+    QCOMPARE(replayed[2].text, QStringLiteral("half"));
+}
+
+// A record cut short, in its header or in its payload, ends the replay; the records before it still apply
+void TestEditJournal::replay_stops_at_truncated_record()
+{
+    EditJournal journal(directory.path());
+    QString journalPath = journal.path_for(source);
+    qint64 complete = 0;
+    qint64 full = 0;
+    {
+        EditJournal writer(directory.path());
+        writer.start(source, pointers());
+        writer.record_change(0, 2, QStringLiteral("first"));
+        complete = QFileInfo(journalPath).size();
+        writer.record_change(1, 2, QStringLiteral("second"));
+        full = QFileInfo(journalPath).size();
+    }
+
+    for (qint64 size : {full - 1, complete + 8, complete + 3})
+    {
+        QVERIFY(QFile::resize(journalPath, size));
+        QVector<TranscriptionElement> replayed;
+        QVERIFY(journal.replay(source, replayed));
+        QCOMPARE(replayed.size(), qsizetype(2));
+        QCOMPARE(replayed[0].text, QStringLiteral("first"));
+        QCOMPARE(replayed[1].text, QStringLiteral("two"));
+    }
+}
+
+void TestEditJournal::truncated_snapshot_is_not_recovered()
+{
+    EditJournal journal(directory.path());
+    QString journalPath = journal.path_for(source);
+    {
+        EditJournal writer(directory.path());
+        writer.start(source, pointers());
+    }
+    QVERIFY(QFile::resize(journalPath, QFileInfo(journalPath).size() - 1));
+    QVector<TranscriptionElement> replayed;
+    QVERIFY(!journal.replay(source, replayed));
+}
+
+void TestEditJournal::other_file_is_not_recovered()
+{
+    {
+        EditJournal writer(directory.path());
+        writer.start(source, pointers());
+    }
+    EditJournal journal(directory.path());
+    QString other = directory.filePath(QStringLiteral("other.srt"));
+    QVERIFY(!journal.exists(other));
+    QVector<TranscriptionElement> replayed;
+    QVERIFY(!journal.replay(other, replayed));
+}
+
+QTEST_MAIN(TestEditJournal)
+#include "tst_editjournal.moc"
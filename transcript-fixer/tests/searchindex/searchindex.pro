@@ -0,0 +1,9 @@
+include(../tests.pri)
+
+TARGET = tst_searchindex
+
+SOURCES += \
+    $$PWD/../../src/searchindex.cpp \
+    tst_searchindex.cpp
+
+HEADERS += $$PWD/../../include/searchindex.h
@@ -0,0 +1,71 @@
+#include "include/searchindex.h"
+#include <QtTest>
+
+class TestSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void last_word_matches_as_prefix();
+    void other_words_match_whole();
+    void blank_or_unknown_query_finds_nothing();
+    void update_row_moves_postings();
+
+private:
+    QVector<TranscriptionElement> rows;
+    SearchIndex index;
+};
+
+void TestSearchIndex::init()
+{
+    rows = {
+        {QString(), QString(), QStringLiteral("The cat sat.")},
+        {QString(), QString(), QStringLiteral("Category theory")},
+        {QString(), QString(), QStringLiteral("a dog, barking")},
+        {QString(), QString(), QStringLiteral("cattle and the cat")}};
+    QVector<TranscriptionElement*> elements;
+    for (TranscriptionElement& row : rows)
+    {
+        elements.push_back(&row);
+    }
+    index.rebuild(elements);
+}
+
+// Results follow the typing, and a row with several completions of the prefix is reported once
+void TestSearchIndex::last_word_matches_as_prefix()
+{
+    QCOMPARE(index.find(QStringLiteral("cat")), QVector<int>({0, 1, 3}));
+    QCOMPARE(index.find(QStringLiteral("CATT")), QVector<int>({3}));
+    QCOMPARE(index.find(QStringLiteral("the ca")), QVector<int>({0, 3}));
+    QCOMPARE(index.find(QStringLiteral("th")), QVector<int>({0, 1, 3}));
+}
+
+void TestSearchIndex::other_words_match_whole()
+{
+    QCOMPARE(index.find(QStringLiteral("cat sat")), QVector<int>({0}));
+    QCOMPARE(index.find(QStringLiteral("ca sat")), QVector<int>());
+    QCOMPARE(index.find(QStringLiteral("dog, bark")), QVector<int>({2}));
+    QCOMPARE(index.find(QStringLiteral("the the")), QVector<int>({0, 3}));
+}
+
+void TestSearchIndex::blank_or_unknown_query_finds_nothing()
+{
+    QCOMPARE(index.find(QString()), QVector<int>());
+    QCOMPARE(index.find(QStringLiteral(" ,. ")), QVector<int>());
+    QCOMPARE(index.find(QStringLiteral("zebra")), QVector<int>());
+    QCOMPARE(index.find(QStringLiteral("zzz")), QVector<int>());
+}
+
+void TestSearchIndex::update_row_moves_postings()
+{
+    index.update_row(2, QStringLiteral("catalog"));
+    QCOMPARE(index.find(QStringLiteral("cat")), QVector<int>({0, 1, 2, 3}));
+    QCOMPARE(index.find(QStringLiteral("dog")), QVector<int>());
+    index.update_row(0, QString());
+    QCOMPARE(index.find(QStringLiteral("sat")), QVector<int>());
+    QCOMPARE(index.find(QStringLiteral("the")), QVector<int>({1, 3}));
+}
+
+QTEST_MAIN(TestSearchIndex)
+#include "tst_searchindex.moc"
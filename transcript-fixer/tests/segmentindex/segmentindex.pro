@@ -0,0 +1,9 @@
+include(../tests.pri)
+
+TARGET = tst_segmentindex
+
+SOURCES += \
+    $$PWD/../../src/segmentindex.cpp \
+    tst_segmentindex.cpp
+
+HEADERS += $$PWD/../../include/segmentindex.h
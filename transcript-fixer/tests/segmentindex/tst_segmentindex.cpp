@@ -0,0 +1,99 @@
+#include "include/segmentindex.h"
+#include <QtTest>
+
+class TestSegmentIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void query_returns_overlapping_rows();
+    void query_finds_long_earlier_row();
+    void row_at_leaves_gaps_empty();
+    void rows_out_of_time_order();
+};
+
+namespace {
+
+// Builds the index over the rows, which must outlive it
+SegmentIndex index_over(QVector<TranscriptionElement>& rows)
+{
+    QVector<TranscriptionElement*> elements;
+    for (TranscriptionElement& row : rows)
+    {
+        elements.push_back(&row);
+    }
+    SegmentIndex index;
+    index.rebuild(elements);
+    return index;
+}
+
+QVector<int> rows_of(const QVector<SegmentSpan>& spans)
+{
+    QVector<int> rows;
+    for (const SegmentSpan& span : spans)
+    {
+        rows.push_back(span.row);
+    }
+    return rows;
+}
+
+} // namespace
+
+// Windows are half-open: a row that ends where the window starts, or starts where it ends, is outside
+void TestSegmentIndex::query_returns_overlapping_rows()
+{
+    QVector<TranscriptionElement> rows = {
+        {QStringLiteral("00:00:01,000"), QStringLiteral("00:00:02,000"), QString()},
+        {QStringLiteral("00:00:02,000"), QStringLiteral("00:00:03,500"), QString()},
+        {QStringLiteral("00:00:05,000"), QStringLiteral("00:00:06,000"), QString()}};
+    SegmentIndex index = index_over(rows);
+    QCOMPARE(index.size(), qsizetype(3));
+    QCOMPARE(rows_of(index.query(1500, 2500)), QVector<int>({0, 1}));
+    QCOMPARE(rows_of(index.query(3500, 5000)), QVector<int>());
+    QCOMPARE(rows_of(index.query(0, 60000)), QVector<int>({0, 1, 2}));
+    QCOMPARE(rows_of(index.query(5999, 7000)), QVector<int>({2}));
+}
+
+// A long row that started well before the window still overlaps it
+void TestSegmentIndex::query_finds_long_earlier_row()
+{
+    QVector<TranscriptionElement> rows = {
+        {QStringLiteral("00:00:00,000"), QStringLiteral("00:00:10,000"), QString()},
+        {QStringLiteral("00:00:01,000"), QStringLiteral("00:00:02,000"), QString()},
+        {QStringLiteral("00:00:03,000"), QStringLiteral("00:00:04,000"), QString()}};
+    SegmentIndex index = index_over(rows);
+    QCOMPARE(rows_of(index.query(5000, 6000)), QVector<int>({0}));
+    QCOMPARE(rows_of(index.query(3500, 3600)), QVector<int>({0, 2}));
+    QCOMPARE(rows_of(index.query(10000, 11000)), QVector<int>());
+}
+
+void TestSegmentIndex::row_at_leaves_gaps_empty()
+{
+    QVector<TranscriptionElement> rows = {
+        {QStringLiteral("00:00:01,000"), QStringLiteral("00:00:02,000"), QString()},
+        {QStringLiteral("00:00:02,000"), QStringLiteral("00:00:03,500"), QString()},
+        {QStringLiteral("00:00:05,000"), QStringLiteral("00:00:06,000"), QString()}};
+    SegmentIndex index = index_over(rows);
+    QCOMPARE(index.row_at(999), -1);
+    QCOMPARE(index.row_at(1000), 0);
+    QCOMPARE(index.row_at(2000), 1);
+    QCOMPARE(index.row_at(3499), 1);
+    QCOMPARE(index.row_at(4000), -1);
+    QCOMPARE(index.row_at(5500), 2);
+    QCOMPARE(index.row_at(6000), -1);
+}
+
+// Rows are reported by their position in the table, even when their times are not in order
+void TestSegmentIndex::rows_out_of_time_order()
+{
+    QVector<TranscriptionElement> rows = {
+        {QStringLiteral("00:00:05,000"), QStringLiteral("00:00:06,000"), QString()},
+        {QStringLiteral("00:00:01,000"), QStringLiteral("00:00:02,000"), QString()}};
+    SegmentIndex index = index_over(rows);
+    QCOMPARE(rows_of(index.query(0, 60000)), QVector<int>({1, 0}));
+    QCOMPARE(index.row_at(1500), 1);
+    QCOMPARE(index.row_at(5500), 0);
+}
+
+QTEST_MAIN(TestSegmentIndex)
+#include "tst_segmentindex.moc"
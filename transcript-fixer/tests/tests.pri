@@ -0,0 +1,19 @@
+QT       += core gui widgets testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+# The sources under test are compiled from the application tree
+INCLUDEPATH += $$PWD/.. $$PWD/../../subtitle-parser/include
+
+# Shared by every test: transcription rows and their time helpers
+SOURCES += \
+    $$PWD/../../subtitle-parser/src/subtitle.cpp \
+    $$PWD/../src/energyenvelope.cpp \
+    $$PWD/../src/utils.cpp
+
+HEADERS += \
+    $$PWD/../../subtitle-parser/include/subtitle.h \
+    $$PWD/../include/energyenvelope.h \
+    $$PWD/../include/params.h \
+    $$PWD/../include/utils.h
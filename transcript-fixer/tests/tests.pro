@@ -0,0 +1,9 @@
+TEMPLATE = subdirs
+
+# One QtTest executable per class under test, `make check` runs them all
+SUBDIRS += \
+    editjournal \
+    searchindex \
+    segmentindex \
+    transcriptlinter \
+    utils
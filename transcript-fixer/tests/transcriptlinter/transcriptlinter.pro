@@ -0,0 +1,11 @@
+include(../tests.pri)
+
+QT += concurrent
+
+TARGET = tst_transcriptlinter
+
+SOURCES += \
+    $$PWD/../../src/transcriptlinter.cpp \
+    tst_transcriptlinter.cpp
+
+HEADERS += $$PWD/../../include/transcriptlinter.h
@@ -0,0 +1,86 @@
+#include "include/transcriptlinter.h"
+#include <QtTest>
+
+class TestTranscriptLinter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void split_reports_new_rows_and_successor();
+    void removal_rechecks_successor();
+    void invalid_range_is_ignored();
+
+private:
+    TranscriptLinter linter;
+
+    void rebuild(QVector<TranscriptionElement> rows);
+};
+
+namespace {
+
+TranscriptionElement element(qint64 startMs, qint64 endMs, const QString &text = QStringLiteral("text"))
+{
+    return {utils::format_timestamp(startMs), utils::format_timestamp(endMs), text};
+}
+
+} // namespace
+
+void TestTranscriptLinter::rebuild(QVector<TranscriptionElement> rows)
+{
+    QVector<TranscriptionElement*> elements;
+    for (TranscriptionElement& row : rows)
+    {
+        elements.push_back(&row);
+    }
+    linter.rebuild(elements);
+}
+
+// The new rows are always reported, the row after them only when its flags change
+void TestTranscriptLinter::split_reports_new_rows_and_successor()
+{
+    rebuild({element(0, 1000), element(1000, 2000), element(2000, 3000), element(3000, 4000)});
+    QCOMPARE(linter.rows_with_issues(), qsizetype(0));
+
+    QCOMPARE(linter.replace_rows(1, 1, {element(1000, 1500), element(1500, 2500)}), QVector<int>({1, 2, 3}));
+    QCOMPARE(linter.issues(3), quint8(Overlap));
+    QCOMPARE(linter.issues(4), quint8(NoIssue));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(1));
+
+    QCOMPARE(linter.replace_rows(1, 2, {element(1000, 2000)}), QVector<int>({1, 2}));
+    QCOMPARE(linter.issues(2), quint8(NoIssue));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(0));
+}
+
+// Removing rows gives the row after them a new predecessor, which can clear or raise its flags
+void TestTranscriptLinter::removal_rechecks_successor()
+{
+    rebuild({element(0, 1000), element(500, 1500), element(1500, 2500), element(20000, 21000)});
+    QCOMPARE(linter.issues(1), quint8(Overlap));
+    QCOMPARE(linter.issues(3), quint8(LongGap));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(2));
+
+    QCOMPARE(linter.replace_rows(1, 1, {}), QVector<int>());
+    QCOMPARE(linter.issues(1), quint8(NoIssue));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(1));
+
+    QCOMPARE(linter.replace_rows(0, 2, {}), QVector<int>({0}));
+    QCOMPARE(linter.issues(0), quint8(NoIssue));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(0));
+
+    QCOMPARE(linter.replace_rows(1, 0, {element(35000, 34000)}), QVector<int>({1}));
+    QCOMPARE(linter.issues(1), quint8(NegativeDuration | LongGap));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(1));
+}
+
+void TestTranscriptLinter::invalid_range_is_ignored()
+{
+    rebuild({element(0, 1000), element(500, 1500)});
+    QCOMPARE(linter.replace_rows(2, 1, {}), QVector<int>());
+    QCOMPARE(linter.replace_rows(-1, 1, {}), QVector<int>());
+    QCOMPARE(linter.replace_rows(0, -1, {}), QVector<int>());
+    QCOMPARE(linter.issues(1), quint8(Overlap));
+    QCOMPARE(linter.rows_with_issues(), qsizetype(1));
+}
+
+QTEST_MAIN(TestTranscriptLinter)
+#include "tst_transcriptlinter.moc"
@@ -0,0 +1,72 @@
+#include "include/utils.h"
+#include "include/energyenvelope.h"
+#include <QtTest>
+
+class TestUtils : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void format_timestamp_round_trips();
+    void parse_time_rejects_invalid();
+    void split_keeps_milliseconds();
+    void split_snaps_to_quiet_frame();
+};
+
+void TestUtils::format_timestamp_round_trips()
+{
+    for (qint64 ms : {0LL, 1234LL, 59999LL, 3600000LL + 61001LL, 25LL * 3600000 + 7LL})
+    {
+        QCOMPARE(utils::convert_time_to_ms(utils::format_timestamp(ms)), ms);
+    }
+}
+
+// A hand-typed time that does not parse is reported, not read as 0 ms
+void TestUtils::parse_time_rejects_invalid()
+{
+    qint64 ms = -1;
+    QVERIFY(utils::parse_time_ms(QStringLiteral("01:02:03,004"), ms));
+    QCOMPARE(ms, qint64(3723004));
+    QVERIFY(utils::parse_time_ms(QStringLiteral("02:03.5"), ms));
+    QCOMPARE(ms, qint64(123500));
+    for (const QString &text : {QStringLiteral(""), QStringLiteral("1:2x"), QStringLiteral("00:61:00,000 ms")})
+    {
+        QVERIFY2(!utils::parse_time_ms(text, ms), qPrintable(text));
+    }
+}
+
+// The boundary of a split lands on exact milliseconds, and the original start and end survive
+void TestUtils::split_keeps_milliseconds()
+{
+    std::vector<std::pair<QString, QString>>* times =
+        utils::adjust_timestamp(QStringLiteral("00:00:00,617"), QStringLiteral("00:00:01,851"), {QStringLiteral("ab"), QStringLiteral("ab")});
+    QCOMPARE(times->size(), std::size_t(2));
+    QCOMPARE(times->at(0).first, QStringLiteral("00:00:00,617"));
+    QCOMPARE(times->at(0).second, QStringLiteral("00:00:01,234"));
+    QCOMPARE(utils::convert_time_to_ms(times->at(1).first), qint64(1234));
+    QCOMPARE(times->at(1).second, QStringLiteral("00:00:01,851"));
+    delete times;
+}
+
+// With an envelope the boundary moves to the silent frame near the proportional position
+void TestUtils::split_snaps_to_quiet_frame()
+{
+    const int sampleRate = 8000;
+    QVector<double> samples(2 * sampleRate, 0.5);
+    for (int i = 1100 * sampleRate / 1000; i < 1200 * sampleRate / 1000; ++i)
+    {
+        samples[i] = 0; // 100 ms of silence from 1100 ms
+    }
+    EnergyEnvelope envelope;
+    envelope.build(samples, sampleRate);
+
+    std::vector<std::pair<QString, QString>>* times =
+        utils::adjust_timestamp(QStringLiteral("00:00:00,000"), QStringLiteral("00:00:02,000"), {QStringLiteral("ab"), QStringLiteral("ab")}, &envelope);
+    qint64 boundary = utils::convert_time_to_ms(times->at(0).second);
+    QVERIFY(boundary >= 1100 && boundary < 1200);
+    QCOMPARE(times->at(1).first, times->at(0).second);
+    delete times;
+}
+
+QTEST_MAIN(TestUtils)
+#include "tst_utils.moc"
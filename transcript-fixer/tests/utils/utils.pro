@@ -0,0 +1,5 @@
+include(../tests.pri)
+
+TARGET = tst_utils
+
+SOURCES += tst_utils.cpp
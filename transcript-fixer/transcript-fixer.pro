@@ -1,6 +1,6 @@
 QT       += core gui
 
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets multimedia opengl printsupport
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets multimedia opengl printsupport concurrent
 
 CONFIG += c++17
 
@@ -10,22 +10,43 @@ QMAKE_CXXFLAGS += -Wall -Wextra
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# SRT/WebVTT/bracketed parser shared with the WER tool
+INCLUDEPATH += ../subtitle-parser/include
+
 SOURCES += \
+    ../subtitle-parser/src/subtitle.cpp \
+    src/energyenvelope.cpp \
+    src/findreplacedialog.cpp \
     src/main.cpp \
+    src/editjournal.cpp \
     src/mainwindow.cpp \
     src/mediacontrol.cpp \
+    src/transcriptioncommands.cpp \
     src/transcriptionmanager.cpp \
+    src/transcriptlinter.cpp \
     src/utils.cpp \
+    src/voiceactivity.cpp \
     src/qcustomplot.cpp \
+    src/searchindex.cpp \
+    src/segmentindex.cpp \
     src/waveform.cpp
 
 HEADERS += \
+    ../subtitle-parser/include/subtitle.h \
+    include/editjournal.h \
+    include/energyenvelope.h \
+    include/findreplacedialog.h \
     include/mainwindow.h \
     include/mediacontrol.h \
     include/params.h \
+    include/transcriptioncommands.h \
     include/transcriptionmanager.h \
+    include/transcriptlinter.h \
     include/utils.h \
+    include/voiceactivity.h \
     include/qcustomplot.h \
+    include/searchindex.h \
+    include/segmentindex.h \
     include/waveform.h
 
 FORMS += \